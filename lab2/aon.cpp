@@ -0,0 +1,297 @@
+#include "aon.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "cpm.h"
+
+using namespace std;
+
+namespace {
+
+// Параллельный цикл по [begin, end); мелкие диапазоны выполняются в
+// текущем потоке, чтобы не платить за создание потоков на каждом уровне
+template <typename F>
+void parallelFor(int begin, int end, int threads, F fn) {
+    const int n = end - begin;
+    if (threads <= 1 || n < 4096) {
+        for (int i = begin; i < end; i++) fn(i);
+        return;
+    }
+    
+    vector<thread> pool;
+    const int chunk = (n + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        int from = begin + t * chunk;
+        int to = min(end, from + chunk);
+        if (from >= to) break;
+        pool.emplace_back([from, to, &fn]() {
+            for (int i = from; i < to; i++) fn(i);
+        });
+    }
+    for (thread& worker : pool) worker.join();
+}
+
+bool parseLinkType(const string& text, LinkType& type) {
+    if (text == "FS") type = LinkType::FS;
+    else if (text == "SS") type = LinkType::SS;
+    else if (text == "FF") type = LinkType::FF;
+    else if (text == "SF") type = LinkType::SF;
+    else return false;
+    return true;
+}
+
+// Задержка связи: целое со знаком, строка должна быть разобрана целиком
+bool parseLag(const string& text, int& lag) {
+    const char* begin = text.data();
+    const char* end = text.data() + text.size();
+    // from_chars не принимает явный плюс
+    if (begin != end && *begin == '+' && ++begin != end && *begin == '-') return false;
+    auto [last, error] = from_chars(begin, end, lag);
+    return error == errc() && last == end;
+}
+
+// Поле CSV: кавычки только если в значении есть разделители
+void writeCsvField(BufferedWriter& out, const string& value) {
+    if (value.find_first_of(",\"\r\n") == string::npos) {
+        out.write(value);
+        return;
+    }
+    out.write('"');
+    for (char c : value) {
+        if (c == '"') out.write('"');
+        out.write(c);
+    }
+    out.write('"');
+}
+
+}  // namespace
+
+bool ActivityNetwork::loadFromFile(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << endl;
+        return false;
+    }
+    
+    activities.clear();
+    links.clear();
+    
+    // Идентификаторы сжимаются в плотные номера; предшественник может
+    // встретиться в файле раньше собственной строки
+    unordered_map<string, int> index;
+    auto indexOf = [&](const string& id) {
+        auto [it, inserted] = index.try_emplace(id, (int)activities.size());
+        if (inserted) {
+            activities.emplace_back();
+            activities.back().id = id;
+        }
+        return it->second;
+    };
+    
+    string line;
+    int line_number = 0;
+    while (getline(file, line)) {
+        line_number++;
+        if (line.empty() || line[0] == '#') continue;
+        
+        istringstream iss(line);
+        string id;
+        int duration;
+        if (!(iss >> id >> duration)) continue;
+        
+        int activity = indexOf(id);
+        activities[activity].duration = duration;
+        
+        string spec;
+        while (iss >> spec) {
+            // <пред>[:<тип>[<+-задержка>]]
+            Link link{0, activity, LinkType::FS, 0};
+            size_t colon = spec.find(':');
+            link.from = indexOf(spec.substr(0, colon));
+            if (colon != string::npos) {
+                string rest = spec.substr(colon + 1);
+                if (rest.size() < 2 || !parseLinkType(rest.substr(0, 2), link.type)) {
+                    cerr << "Ошибка: неверная связь '" << spec << "' в строке "
+                         << line_number << endl;
+                    return false;
+                }
+                if (rest.size() > 2 && !parseLag(rest.substr(2), link.lag)) {
+                    cerr << "Ошибка: неверная задержка в связи '" << spec << "' в строке "
+                         << line_number << endl;
+                    return false;
+                }
+            }
+            links.push_back(link);
+        }
+    }
+    
+    if (activities.empty()) {
+        cerr << "Ошибка: Файл не содержит данных" << endl;
+        return false;
+    }
+    for (const Activity& a : activities) {
+        if (a.duration < 0) {
+            cerr << "Ошибка: не задана продолжительность работы " << a.id << endl;
+            return false;
+        }
+    }
+    return buildIndex();
+}
+
+// Построение CSR-индексов связей и уровней топологического порядка
+// (алгоритм Кана); при наличии цикла возвращает false
+bool ActivityNetwork::buildIndex() {
+    const int n = activities.size();
+    
+    pred_offset.assign(n + 1, 0);
+    succ_offset.assign(n + 1, 0);
+    for (const Link& link : links) {
+        pred_offset[link.to + 1]++;
+        succ_offset[link.from + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        pred_offset[i + 1] += pred_offset[i];
+        succ_offset[i + 1] += succ_offset[i];
+    }
+    pred_links.resize(links.size());
+    succ_links.resize(links.size());
+    vector<int> pred_pos(pred_offset.begin(), pred_offset.end() - 1);
+    vector<int> succ_pos(succ_offset.begin(), succ_offset.end() - 1);
+    for (size_t k = 0; k < links.size(); k++) {
+        pred_links[pred_pos[links[k].to]++] = k;
+        succ_links[succ_pos[links[k].from]++] = k;
+    }
+    
+    vector<int> in_degree(n);
+    for (int i = 0; i < n; i++) in_degree[i] = pred_offset[i + 1] - pred_offset[i];
+    
+    level_order.clear();
+    level_offset.assign(1, 0);
+    for (int i = 0; i < n; i++) {
+        if (in_degree[i] == 0) level_order.push_back(i);
+    }
+    size_t level_begin = 0;
+    while (level_begin < level_order.size()) {
+        size_t level_end = level_order.size();
+        level_offset.push_back(level_end);
+        for (size_t p = level_begin; p < level_end; p++) {
+            int a = level_order[p];
+            for (int s = succ_offset[a]; s < succ_offset[a + 1]; s++) {
+                int next = links[succ_links[s]].to;
+                if (--in_degree[next] == 0) level_order.push_back(next);
+            }
+        }
+        level_begin = level_end;
+    }
+    
+    if ((int)level_order.size() < n) {
+        cerr << "Ошибка: связи между работами образуют цикл" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool ActivityNetwork::calculateAll(int threads) {
+    if (activities.empty() || (int)level_order.size() < (int)activities.size()) {
+        cerr << "Ошибка: Нет данных для расчета" << endl;
+        return false;
+    }
+    const int levels = level_offset.size() - 1;
+    
+    // Прямой проход: каждая работа читает сроки предшественников с
+    // предыдущих уровней, поэтому работы одного уровня независимы
+    for (int level = 0; level < levels; level++) {
+        parallelFor(level_offset[level], level_offset[level + 1], threads, [this](int p) {
+            Activity& a = activities[level_order[p]];
+            int es = 0;
+            for (int q = pred_offset[level_order[p]]; q < pred_offset[level_order[p] + 1]; q++) {
+                const Link& link = links[pred_links[q]];
+                const Activity& pred = activities[link.from];
+                switch (link.type) {
+                case LinkType::FS: es = max(es, pred.early_finish + link.lag); break;
+                case LinkType::SS: es = max(es, pred.early_start + link.lag); break;
+                case LinkType::FF: es = max(es, pred.early_finish + link.lag - a.duration); break;
+                case LinkType::SF: es = max(es, pred.early_start + link.lag - a.duration); break;
+                }
+            }
+            a.early_start = es;
+            a.early_finish = es + a.duration;
+        });
+    }
+    
+    project_duration = 0;
+    for (const Activity& a : activities) {
+        project_duration = max(project_duration, a.early_finish);
+    }
+    
+    // Обратный проход по уровням в обратном порядке
+    for (int level = levels - 1; level >= 0; level--) {
+        parallelFor(level_offset[level], level_offset[level + 1], threads, [this](int p) {
+            int index = level_order[p];
+            Activity& a = activities[index];
+            int lf = project_duration;
+            for (int q = succ_offset[index]; q < succ_offset[index + 1]; q++) {
+                const Link& link = links[succ_links[q]];
+                const Activity& succ = activities[link.to];
+                switch (link.type) {
+                case LinkType::FS: lf = min(lf, succ.late_start - link.lag); break;
+                case LinkType::SS: lf = min(lf, succ.late_start - link.lag + a.duration); break;
+                case LinkType::FF: lf = min(lf, succ.late_finish - link.lag); break;
+                case LinkType::SF: lf = min(lf, succ.late_finish - link.lag + a.duration); break;
+                }
+            }
+            a.late_finish = lf;
+            a.late_start = lf - a.duration;
+        });
+    }
+    
+    // Резервы: свободный резерв - минимальный запас по исходящим связям
+    parallelFor(0, activities.size(), threads, [this](int index) {
+        Activity& a = activities[index];
+        a.total_float = a.late_start - a.early_start;
+        
+        int free_float = project_duration - a.early_finish;
+        for (int q = succ_offset[index]; q < succ_offset[index + 1]; q++) {
+            const Link& link = links[succ_links[q]];
+            const Activity& succ = activities[link.to];
+            int slack = 0;
+            switch (link.type) {
+            case LinkType::FS: slack = succ.early_start - link.lag - a.early_finish; break;
+            case LinkType::SS: slack = succ.early_start - link.lag - a.early_start; break;
+            case LinkType::FF: slack = succ.early_finish - link.lag - a.early_finish; break;
+            case LinkType::SF: slack = succ.early_finish - link.lag - a.early_start; break;
+            }
+            free_float = min(free_float, slack);
+        }
+        a.free_float = max(0, free_float);
+    });
+    return true;
+}
+
+bool ActivityNetwork::writeCsv(const string& filename) const {
+    BufferedWriter out(filename);
+    if (!out.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << endl;
+        return false;
+    }
+    
+    out.write(string("id,duration,early_start,early_finish,late_start,late_finish,"
+                     "total_float,free_float,critical\n"));
+    for (const Activity& a : activities) {
+        writeCsvField(out, a.id);
+        for (int value : {a.duration, a.early_start, a.early_finish, a.late_start,
+                          a.late_finish, a.total_float, a.free_float}) {
+            out.write(',');
+            out.writeInt(value);
+        }
+        out.write(a.total_float == 0 ? ",1\n" : ",0\n", 3);
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+// Сетевой график в форме "работы в вершинах" (precedence diagram) со
+// связями FS/SS/FF/SF и задержками. Не требует фиктивных работ, в отличие
+// от NetworkGraph, где связи бывают только вида "окончание-начало".
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Тип связи: предшественник -> последователь
+enum class LinkType {
+    FS,  // окончание - начало
+    SS,  // начало - начало
+    FF,  // окончание - окончание
+    SF   // начало - окончание
+};
+
+struct Activity {
+    std::string id;      // идентификатор из файла
+    int duration;        // продолжительность
+    
+    int early_start;     // раннее начало
+    int early_finish;    // раннее окончание
+    int late_start;      // позднее начало
+    int late_finish;     // позднее окончание
+    int total_float;     // полный резерв
+    int free_float;      // свободный резерв
+    
+    Activity() : duration(-1), early_start(0), early_finish(0), late_start(0),
+                 late_finish(0), total_float(0), free_float(0) {}
+};
+
+struct Link {
+    int from;            // предшественник
+    int to;              // последователь
+    LinkType type;
+    int lag;             // задержка (может быть отрицательной)
+};
+
+class ActivityNetwork {
+private:
+    std::vector<Activity> activities;
+    std::vector<Link> links;
+    
+    // Связи в сжатом виде (CSR), упорядоченные по последователю и по предшественнику
+    std::vector<int> pred_offset, pred_links;
+    std::vector<int> succ_offset, succ_links;
+    
+    // Активности, сгруппированные по уровням топологического порядка:
+    // все предшественники активности лежат на более ранних уровнях
+    std::vector<int> level_offset, level_order;
+    
+    int project_duration;
+    
+    bool buildIndex();
+
+public:
+    ActivityNetwork() : project_duration(0) {}
+    
+    // Загрузка из файла; строка: "<id> <длит> [<пред>[:<тип>[<+-задержка>]] ...]",
+    // например "C 5 A B:SS+2 D:FF-1" (тип по умолчанию FS, задержка 0)
+    bool loadFromFile(const std::string& filename);
+    
+    // Расчет сроков и резервов; проходы по уровням выполняются в threads потоках
+    bool calculateAll(int threads = 1);
+    
+    const std::vector<Activity>& getActivities() const { return activities; }
+    const std::vector<Link>& getLinks() const { return links; }
+    int projectDuration() const { return project_duration; }
+    
+    // Запись результатов в CSV (filename "-" - stdout)
+    bool writeCsv(const std::string& filename) const;
+};
@@ -0,0 +1,49 @@
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "aon.h"
+
+using namespace std;
+
+// Расчет сетевого графика "работы в вершинах":
+//   aon <файл> [--threads N] [--output <файл>|-]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Использование: " << argv[0]
+             << " <файл> [--threads N] [--output <файл>|-]" << endl;
+        return 1;
+    }
+    
+    int threads = max(1u, thread::hardware_concurrency());
+    string output = "-";
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Ошибка: не задано значение для " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--threads") {
+            auto [end, error] = from_chars(value.data(), value.data() + value.size(), threads);
+            if (error != errc() || end != value.data() + value.size() || threads < 1) {
+                cerr << "Ошибка: неверное число потоков " << value << endl;
+                return 1;
+            }
+        } else if (arg == "--output") {
+            output = value;
+        } else {
+            cerr << "Ошибка: неизвестный параметр " << arg << endl;
+            return 1;
+        }
+    }
+    
+    ActivityNetwork network;
+    if (!network.loadFromFile(argv[1])) return 1;
+    if (!network.calculateAll(threads)) return 1;
+    if (!network.writeCsv(output)) return 1;
+    
+    cerr << "Длительность проекта: " << network.projectDuration() << endl;
+    return 0;
+}
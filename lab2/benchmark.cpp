@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpm.h"
+#include "netgen.h"
+
+using namespace std;
+
+// Лучшее время каждого этапа за несколько повторов, секунды
+struct BenchmarkRow {
+    string shape;
+    long long works = 0;
+    int events = 0;
+    double load = 1e100;
+    CalculationTimes calc{1e100, 1e100, 1e100, 1e100};
+    double critical = 1e100;
+};
+
+vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void writeRow(BufferedWriter& out, const BenchmarkRow& row, bool json) {
+    char line[512];
+    double total = row.load + row.calc.validate + row.calc.forward
+                   + row.calc.backward + row.calc.floats + row.critical;
+    if (json) {
+        snprintf(line, sizeof(line),
+                 "{\"shape\":\"%s\",\"works\":%lld,\"events\":%d,\"load\":%.6f,"
+                 "\"validate\":%.6f,\"forward\":%.6f,\"backward\":%.6f,"
+                 "\"floats\":%.6f,\"critical\":%.6f,\"total\":%.6f}\n",
+                 row.shape.c_str(), row.works, row.events, row.load,
+                 row.calc.validate, row.calc.forward, row.calc.backward,
+                 row.calc.floats, row.critical, total);
+    } else {
+        snprintf(line, sizeof(line), "%s,%lld,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                 row.shape.c_str(), row.works, row.events, row.load,
+                 row.calc.validate, row.calc.forward, row.calc.backward,
+                 row.calc.floats, row.critical, total);
+    }
+    out.write(line);
+    out.flush();
+}
+
+// Нагрузочное тестирование расчета сетевого графика:
+//   benchmark [--shapes layered,sp,chain,fanout] [--sizes 1000,10000,...]
+//             [--repeats N] [--format csv|json] [--output <файл>|-]
+//             [--network <временный файл>]
+int main(int argc, char* argv[]) {
+    vector<string> shapes = {"layered", "sp", "chain", "fanout"};
+    vector<string> sizes = {"1000", "10000", "100000", "1000000"};
+    int repeats = 3;
+    bool json = false;
+    string output = "-";
+    string network_file = "bench_network.txt";
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Ошибка: не задано значение для " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--shapes") shapes = splitList(value);
+        else if (arg == "--sizes") sizes = splitList(value);
+        else if (arg == "--repeats") repeats = max(1, stoi(value));
+        else if (arg == "--format") {
+            if (value != "csv" && value != "json") {
+                cerr << "Ошибка: неизвестный формат " << value << endl;
+                return 1;
+            }
+            json = (value == "json");
+        }
+        else if (arg == "--output") output = value;
+        else if (arg == "--network") network_file = value;
+        else {
+            cerr << "Ошибка: неизвестный параметр " << arg << endl;
+            return 1;
+        }
+    }
+    
+    BufferedWriter out(output);
+    if (!out.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << output << endl;
+        return 1;
+    }
+    if (!json) {
+        out.write(string("shape,works,events,load,validate,forward,backward,"
+                         "floats,critical,total\n"));
+    }
+    
+    using Clock = chrono::steady_clock;
+    auto elapsed = [](Clock::time_point from) {
+        return chrono::duration<double>(Clock::now() - from).count();
+    };
+    
+    for (const string& shape_name : shapes) {
+        NetworkShape shape;
+        if (!parseNetworkShape(shape_name, shape)) {
+            cerr << "Ошибка: неизвестная форма сети " << shape_name << endl;
+            return 1;
+        }
+        for (const string& size : sizes) {
+            if (!generateNetwork(network_file, shape, stoll(size))) return 1;
+            
+            BenchmarkRow row;
+            row.shape = shape_name;
+            for (int r = 0; r < repeats; r++) {
+                NetworkGraph graph;
+                graph.setVerbose(false);
+                
+                Clock::time_point t = Clock::now();
+                if (!graph.loadFromFile(network_file)) return 1;
+                row.load = min(row.load, elapsed(t));
+                
+                CalculationTimes calc;
+                if (!graph.calculateAll(&calc)) return 1;
+                row.calc.validate = min(row.calc.validate, calc.validate);
+                row.calc.forward = min(row.calc.forward, calc.forward);
+                row.calc.backward = min(row.calc.backward, calc.backward);
+                row.calc.floats = min(row.calc.floats, calc.floats);
+                
+                // Извлечение критического подграфа и одного критического пути
+                t = Clock::now();
+                graph.countCriticalPaths();
+                graph.findCriticalPaths(1);
+                row.critical = min(row.critical, elapsed(t));
+                
+                row.works = graph.getWorks().size();
+                row.events = graph.getNumEvents();
+            }
+            writeRow(out, row, json);
+        }
+    }
+    
+    remove(network_file.c_str());
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cpm.h"
+#include "probability.h"
+
+using namespace std;
+
+// Вероятность завершения проекта в срок:
+//   completion <граф> <распределения> [срок ...] [--mc N]
+// Без сроков выводятся квантили распределения срока проекта.
+// С --mc N результат сравнивается с N испытаниями Монте-Карло.
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Использование: " << argv[0]
+             << " <граф> <распределения> [срок ...] [--mc N]" << endl;
+        return 1;
+    }
+    
+    vector<int> deadlines;
+    int iterations = 0;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--mc" && i + 1 < argc) iterations = stoi(argv[++i]);
+        else deadlines.push_back(stoi(arg));
+    }
+    
+    NetworkGraph graph;
+    graph.setVerbose(false);
+    if (!graph.loadFromFile(argv[1]) || !graph.calculateAll()) return 1;
+    
+    vector<DiscreteDistribution> distributions;
+    if (!loadDurationDistributions(graph, argv[2], distributions)) return 1;
+    
+    auto begin = chrono::steady_clock::now();
+    vector<double> cdf = completionTimeCdf(graph, distributions);
+    double analytic_seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    
+    vector<double> simulated;
+    double mc_seconds = 0;
+    if (iterations > 0) {
+        begin = chrono::steady_clock::now();
+        simulated = simulateCompletionTimeCdf(graph, distributions, iterations);
+        mc_seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    }
+    
+    auto probability = [](const vector<double>& f, int t) {
+        if (t < 0) return 0.0;
+        return t < (int)f.size() ? f[t] : 1.0;
+    };
+    
+    cout << "Срок при продолжительностях из графа (CPM): " << graph.criticalTime() << endl;
+    if (deadlines.empty()) {
+        for (double q : {0.5, 0.9, 0.95, 0.99}) {
+            int t = lower_bound(cdf.begin(), cdf.end(), q - 1e-12) - cdf.begin();
+            cout << "Квантиль " << q << ": " << t << endl;
+        }
+    } else {
+        cout << left << setw(10) << "Срок" << setw(18) << "P(T <= срок)";
+        if (iterations > 0) cout << "Монте-Карло";
+        cout << endl;
+        for (int deadline : deadlines) {
+            cout << left << setw(6) << deadline << setw(14) << fixed << setprecision(6)
+                 << probability(cdf, deadline);
+            if (iterations > 0) cout << probability(simulated, deadline);
+            cout << endl;
+        }
+    }
+    
+    cerr << "Время: свертка " << analytic_seconds << " с";
+    if (iterations > 0) cerr << ", Монте-Карло " << mc_seconds << " с";
+    cerr << endl;
+    return 0;
+}
@@ -0,0 +1,986 @@
+#include "cpm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+// Поле CSV: кавычки только если в значении есть разделители
+void writeCsvField(BufferedWriter& out, const string& value) {
+    if (value.find_first_of(",\"\n") == string::npos) {
+        out.write(value);
+        return;
+    }
+    out.write('"');
+    for (char c : value) {
+        if (c == '"') out.write('"');
+        out.write(c);
+    }
+    out.write('"');
+}
+
+// Строка JSON с экранированием служебных символов
+void writeJsonString(BufferedWriter& out, const string& value) {
+    out.write('"');
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            out.write('\\');
+            out.write(static_cast<char>(c));
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out.write(escaped, 6);
+        } else {
+            out.write(static_cast<char>(c));
+        }
+    }
+    out.write('"');
+}
+
+}  // namespace
+
+// Имя события для вывода: внешний идентификатор или внутренний номер
+string NetworkGraph::eventName(int event) const {
+    if (event < (int)event_names.size() && !event_names[event].empty()) {
+        return event_names[event];
+    }
+    return to_string(event);
+}
+
+// Длина критического пути (максимальное раннее окончание)
+int NetworkGraph::criticalTime() const {
+    int critical_time = 0;
+    for (const Work& w : works) {
+        critical_time = max(critical_time, w.t_early_finish);
+    }
+    return critical_time;
+}
+
+// Топологический порядок событий (алгоритм Кана, O(V+E))
+vector<int> NetworkGraph::topologicalOrder() const {
+    vector<int> in_degree(num_events + 1, 0);
+    for (const Work& w : works) {
+        in_degree[w.end]++;
+    }
+    
+    vector<int> order;
+    order.reserve(num_events);
+    for (int i = 1; i <= num_events; i++) {
+        if (in_degree[i] == 0) order.push_back(i);
+    }
+    
+    for (size_t head = 0; head < order.size(); head++) {
+        for (int work_idx : outWorks(order[head])) {
+            int next = works[work_idx].end;
+            if (--in_degree[next] == 0) order.push_back(next);
+        }
+    }
+    return order;
+}
+
+// Поиск цикла среди событий, не попавших в топологический порядок.
+// Возвращает последовательность событий цикла (первое = последнее).
+vector<int> NetworkGraph::findCycle(const vector<int>& order) const {
+    vector<char> state(num_events + 1, 0); // 0 - не посещено, 1 - в стеке, 2 - закрыто
+    for (int event : order) state[event] = 2;
+    
+    vector<int> stack;
+    vector<size_t> next_edge;
+    for (int root = 1; root <= num_events; root++) {
+        if (state[root] != 0) continue;
+        stack.assign(1, root);
+        next_edge.assign(1, 0);
+        state[root] = 1;
+        
+        while (!stack.empty()) {
+            int event = stack.back();
+            if (next_edge.back() < outWorks(event).size()) {
+                int next = works[outWorks(event)[next_edge.back()++]].end;
+                if (state[next] == 1) {
+                    vector<int> cycle(find(stack.begin(), stack.end(), next), stack.end());
+                    cycle.push_back(next);
+                    return cycle;
+                }
+                if (state[next] == 0) {
+                    state[next] = 1;
+                    stack.push_back(next);
+                    next_edge.push_back(0);
+                }
+            } else {
+                state[event] = 2;
+                stack.pop_back();
+                next_edge.pop_back();
+            }
+        }
+    }
+    return {};
+}
+
+// Построение CSR исходящих и входящих работ подсчетом степеней событий
+void NetworkGraph::buildIndex() {
+    if (index_built) return;
+    
+    out_offset.assign(num_events + 2, 0);
+    in_offset.assign(num_events + 2, 0);
+    for (const Work& w : works) {
+        out_offset[w.start + 1]++;
+        in_offset[w.end + 1]++;
+    }
+    for (int event = 0; event <= num_events; event++) {
+        out_offset[event + 1] += out_offset[event];
+        in_offset[event + 1] += in_offset[event];
+    }
+    
+    out_works.resize(works.size());
+    in_works.resize(works.size());
+    vector<int> out_pos(out_offset.begin(), out_offset.end() - 1);
+    vector<int> in_pos(in_offset.begin(), in_offset.end() - 1);
+    for (size_t k = 0; k < works.size(); k++) {
+        out_works[out_pos[works[k].start]++] = k;
+        in_works[in_pos[works[k].end]++] = k;
+    }
+    index_built = true;
+}
+
+// Добавление фиктивного события, возвращает его номер
+int NetworkGraph::addEvent(const string& name) {
+    num_events++;
+    setEventName(num_events, name);
+    return num_events;
+}
+
+// Проверка графа: поиск циклов (Кан + DFS для вывода цикла, O(V+E)) и
+// сведение нескольких начальных/завершающих событий к одному через
+// фиктивные события и работы нулевой продолжительности.
+bool NetworkGraph::validateGraph() {
+    buildIndex();
+    vector<int> order = topologicalOrder();
+    if ((int)order.size() < num_events) {
+        vector<int> cycle = findCycle(order);
+        cerr << "Ошибка: граф содержит цикл: ";
+        for (size_t i = 0; i < cycle.size(); i++) {
+            cerr << eventName(cycle[i]);
+            if (i < cycle.size() - 1) cerr << " -> ";
+        }
+        cerr << endl;
+        return false;
+    }
+    
+    // Номера событий без работ (пропуски в нумерации) не учитываются
+    vector<int> sources, sinks;
+    for (int event = 1; event <= num_events; event++) {
+        if (outWorks(event).empty() && inWorks(event).empty()) continue;
+        if (inWorks(event).empty()) sources.push_back(event);
+        if (outWorks(event).empty()) sinks.push_back(event);
+    }
+    
+    if (sources.size() > 1) {
+        // Имена с пробелом не совпадут ни с идентификатором из файла, ни
+        // с событием "(начало)" для предшественника 0
+        int source = addEvent("(общее начало)");
+        for (int event : sources) addWork(source, event, 0);
+        if (verbose) cout << "Начальных событий: " << sources.size()
+             << ", добавлено фиктивное начальное событие" << endl;
+    }
+    if (sinks.size() > 1) {
+        int sink = addEvent("(общий конец)");
+        for (int event : sinks) addWork(event, sink, 0);
+        if (verbose) cout << "Завершающих событий: " << sinks.size()
+             << ", добавлено фиктивное завершающее событие" << endl;
+    }
+    buildIndex();
+    return true;
+}
+
+// Поиск максимального пути (ранние сроки)
+void NetworkGraph::calculateEarlyTimes() {
+    vector<int> early_time(num_events + 1, 0);
+    
+    // Топологический порядок
+    for (int i : topologicalOrder()) {
+        for (int work_idx : outWorks(i)) {
+            Work& w = works[work_idx];
+            int new_time = early_time[w.start] + w.duration;
+            if (new_time > early_time[w.end]) {
+                early_time[w.end] = new_time;
+            }
+        }
+    }
+    
+    // Установка ранних сроков для работ
+    for (Work& w : works) {
+        w.t_early_start = early_time[w.start];
+        w.t_early_finish = w.t_early_start + w.duration;
+    }
+}
+
+// Поиск поздних сроков (обратный проход в обратном топологическом порядке)
+void NetworkGraph::calculateLateTimes() {
+    // Для завершающих событий позднее время равно критическому
+    vector<int> late_time(num_events + 1, criticalTime());
+    
+    vector<int> order = topologicalOrder();
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        for (int work_idx : outWorks(*it)) {
+            const Work& w = works[work_idx];
+            late_time[w.start] = min(late_time[w.start], late_time[w.end] - w.duration);
+        }
+    }
+    
+    // Установка поздних сроков для работ
+    for (Work& w : works) {
+        w.t_late_finish = late_time[w.end];
+        w.t_late_start = w.t_late_finish - w.duration;
+    }
+}
+
+// Расчет резервов времени
+void NetworkGraph::calculateFloats() {
+    for (Work& w : works) {
+        // Полный резерв R_ij
+        w.total_float = w.t_late_start - w.t_early_start;
+        
+        // Свободный резерв r_ij
+        int min_early_start_next = INT_MAX;
+        for (int next_idx : outWorks(w.end)) {
+            const Work& next_work = works[next_idx];
+            min_early_start_next = min(min_early_start_next, next_work.t_early_start);
+        }
+        
+        if (min_early_start_next != INT_MAX) {
+            w.free_float = min_early_start_next - w.t_early_finish;
+        } else {
+            w.free_float = 0; // Если нет последующих работ
+        }
+    }
+}
+
+// Загрузка графа из файла
+bool NetworkGraph::loadFromFile(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << endl;
+        return false;
+    }
+    
+    // Очищаем текущие данные
+    works.clear();
+    work_demand.clear();
+    index_built = false;
+    event_names.assign(1, "");
+    
+    // Идентификаторы событий в файле произвольные (числа любой величины
+    // или строки); они сжимаются в плотные номера 1..n через хеш-таблицу,
+    // а обратное отображение хранится в event_names для вывода.
+    unordered_map<string, int> event_index;
+    auto indexOf = [&](const string& id) {
+        auto [it, inserted] = event_index.try_emplace(id, (int)event_names.size());
+        if (inserted) event_names.push_back(id);
+        return it->second;
+    };
+    
+    string line;
+    vector<tuple<int, int, int>> temp_works; // временное хранение работ
+    vector<int> temp_demands;                // потребности работ подряд
+    vector<size_t> temp_demand_offset(1, 0); // начало потребностей работы k
+    vector<tuple<int, int, int, double, double>> temp_crash; // параметры сокращения
+    resource_capacity.clear();
+    
+    // Чтение файла
+    while (getline(file, line)) {
+        // Пропускаем пустые строки и комментарии
+        if (line.empty() || line[0] == '#') continue;
+        
+        istringstream iss(line);
+        string vertex_id, pred_id;
+        int weight;
+        
+        if (!(iss >> vertex_id)) continue;
+        
+        // Строка вида "@R c1 c2 ..." задает объемы ресурсов. Директивы
+        // начинаются с '@', идентификаторы событий с него начинаться не могут
+        if (vertex_id == "@R") {
+            int capacity;
+            while (iss >> capacity) resource_capacity.push_back(capacity);
+            continue;
+        }
+        
+        // Строка вида "@C вершина предшественник срочная_длит норм_ст срочная_ст"
+        if (vertex_id == "@C") {
+            int crash_duration;
+            double normal_cost, crash_cost;
+            if (iss >> vertex_id >> pred_id >> crash_duration >> normal_cost >> crash_cost) {
+                int predecessor = (pred_id == "0") ? 0 : indexOf(pred_id);
+                temp_crash.push_back(make_tuple(predecessor, indexOf(vertex_id),
+                                                crash_duration, normal_cost, crash_cost));
+            }
+            continue;
+        }
+        
+        if (vertex_id[0] == '@') {
+            cerr << "Ошибка: неизвестная директива " << vertex_id << endl;
+            return false;
+        }
+        
+        if (iss >> pred_id >> weight) {
+            if (pred_id[0] == '@') {
+                cerr << "Ошибка: идентификатор события не может начинаться с '@': "
+                     << pred_id << endl;
+                return false;
+            }
+            
+            // Предшественник 0 - начальная работа
+            int predecessor = (pred_id == "0") ? 0 : indexOf(pred_id);
+            int vertex = indexOf(vertex_id);
+            
+            temp_works.push_back(make_tuple(predecessor, vertex, weight));
+            
+            // Необязательные потребности в ресурсах после веса
+            int demand;
+            while (iss >> demand) temp_demands.push_back(demand);
+            temp_demand_offset.push_back(temp_demands.size());
+        }
+    }
+    
+    file.close();
+    
+    if (temp_works.empty()) {
+        cerr << "Ошибка: Файл не содержит данных" << endl;
+        return false;
+    }
+    
+    // Устанавливаем количество событий
+    num_events = event_names.size() - 1;
+    reserveWorks(temp_works.size());
+    
+    // Добавляем работы; предшественник 0 означает начальную работу,
+    // все такие работы выходят из одного фиктивного начального события
+    int start_event = 0;
+    for (const auto& [pred, vertex, weight] : temp_works) {
+        if (pred > 0) {
+            addWork(pred, vertex, weight);
+        } else {
+            if (start_event == 0) start_event = addEvent("(начало)");
+            addWork(start_event, vertex, weight);
+        }
+    }
+    
+    // Потребности в плоский массив n x r (строка "@R" может идти после работ)
+    const size_t r = resource_capacity.size();
+    if (r > 0 && !temp_demands.empty()) {
+        work_demand.assign(works.size() * r, 0);
+        for (size_t k = 0; k + 1 < temp_demand_offset.size(); k++) {
+            size_t count = min(temp_demand_offset[k + 1] - temp_demand_offset[k], r);
+            copy_n(temp_demands.begin() + temp_demand_offset[k], count, work_demand.begin() + k * r);
+        }
+    }
+    
+    // Параметры сокращения относятся к первой работе с той же парой событий
+    if (!temp_crash.empty()) {
+        unordered_map<long long, int> work_index;
+        for (size_t k = 0; k < works.size(); k++) {
+            work_index.try_emplace((long long)works[k].start << 32 | works[k].end, k);
+        }
+        for (const auto& [pred, vertex, crash_duration, normal_cost, crash_cost] : temp_crash) {
+            int from = (pred > 0) ? pred : start_event;
+            auto it = work_index.find((long long)from << 32 | vertex);
+            if (it == work_index.end()) {
+                cerr << "Ошибка: параметры сокращения для несуществующей работы "
+                     << eventName(from) << "-" << eventName(vertex) << endl;
+                return false;
+            }
+            Work& w = works[it->second];
+            w.crash_duration = min(crash_duration, w.duration);
+            w.normal_cost = normal_cost;
+            w.crash_cost = crash_cost;
+        }
+    }
+    
+    if (!validateGraph()) return false;
+    
+    if (verbose) {
+        cout << "Граф успешно загружен из файла " << filename << endl;
+        cout << "Количество событий: " << num_events << endl;
+        cout << "Количество работ: " << works.size() << endl;
+    }
+    
+    return true;
+}
+
+// Добавление работы
+void NetworkGraph::addWork(int i, int j, int duration) {
+    works.push_back(Work(i, j, duration));
+    index_built = false;
+}
+
+// Установка имен событий
+void NetworkGraph::setEventName(int event, const string& name) {
+    if (event >= (int)event_names.size()) event_names.resize(event + 1);
+    event_names[event] = name;
+}
+
+// Расчет всех параметров
+bool NetworkGraph::calculateAll(CalculationTimes* times) {
+    if (works.empty()) {
+        cerr << "Ошибка: Нет данных для расчета" << endl;
+        return false;
+    }
+    
+    using Clock = chrono::steady_clock;
+    auto elapsed = [](Clock::time_point from) {
+        return chrono::duration<double>(Clock::now() - from).count();
+    };
+    
+    Clock::time_point t = Clock::now();
+    if (!validateGraph()) return false;
+    if (times) times->validate = elapsed(t);
+    
+    t = Clock::now();
+    calculateEarlyTimes();
+    if (times) times->forward = elapsed(t);
+    
+    t = Clock::now();
+    calculateLateTimes();
+    if (times) times->backward = elapsed(t);
+    
+    t = Clock::now();
+    calculateFloats();
+    if (times) times->floats = elapsed(t);
+    return true;
+}
+
+// Вывод таблицы сетевого графика
+void NetworkGraph::printTable() const {
+    if (works.empty()) {
+        cout << "Нет данных для отображения" << endl;
+        return;
+    }
+    
+    cout << "\n" << string(100, '=') << endl;
+    cout << "ТАБЛИЦА СЕТЕВОГО ГРАФИКА" << endl;
+    cout << string(100, '=') << endl;
+    
+    // Ширина столбца шифра зависит от длины идентификаторов событий
+    size_t code_width = 10;
+    for (const Work& w : works) {
+        code_width = max(code_width, eventName(w.start).size() + eventName(w.end).size() + 3);
+    }
+    
+    cout << left 
+         << setw(code_width) << "Шифр"
+         << setw(12) << "t(i,j)"
+         << setw(15) << "t^РН_ij"
+         << setw(15) << "t^РО_ij"
+         << setw(15) << "t^ПН_ij"
+         << setw(15) << "t^ПО_ij"
+         << setw(12) << "R_ij"
+         << setw(12) << "r_ij"
+         << "Критич." << endl;
+    
+    cout << string(100, '-') << endl;
+    
+    int critical_path_length = criticalTime();
+    
+    for (size_t k = 0; k < works.size(); k++) {
+        const Work& w = works[k];
+        
+        bool is_critical = (w.total_float == 0);
+        
+        // Формируем шифр работы с учетом имен событий
+        string work_code = eventName(w.start) + "-" + eventName(w.end);
+        
+        cout << left
+             << setw(code_width) << work_code
+             << setw(12) << w.duration
+             << setw(15) << w.t_early_start
+             << setw(15) << w.t_early_finish
+             << setw(15) << w.t_late_start
+             << setw(15) << w.t_late_finish
+             << setw(12) << w.total_float
+             << setw(12) << w.free_float;
+        
+        if (is_critical) {
+            cout << "   Да";
+        } else {
+            cout << "   Нет";
+        }
+        cout << endl;
+    }
+    
+    cout << string(100, '-') << endl;
+    cout << "Длина критического пути: " << critical_path_length << endl;
+    
+    // Вывод критического пути
+    cout << "\nКритический путь: ";
+    findAndPrintCriticalPath();
+    cout << endl;
+}
+
+// Потоковая запись результатов в машиночитаемом формате.
+// Записываются только работы с полным резервом <= float_threshold
+// (0 - только критические). filename "-" означает stdout.
+bool NetworkGraph::writeResults(const string& filename, OutputFormat format,
+                                int float_threshold) const {
+    if (format == OutputFormat::Table) {
+        cerr << "Ошибка: табличный вывод выполняется через printTable()" << endl;
+        return false;
+    }
+    
+    BufferedWriter out(filename);
+    if (!out.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << endl;
+        return false;
+    }
+    
+    if (format == OutputFormat::CSV) {
+        out.write(string("start,end,duration,early_start,early_finish,"
+                         "late_start,late_finish,total_float,free_float,critical\n"));
+    } else if (format == OutputFormat::Binary) {
+        // Заголовок: сигнатура, версия, таблица идентификаторов событий;
+        // далее записи из 9 чисел int32 до конца файла
+        out.write("CPMB", 4);
+        out.writeRaw<uint32_t>(1);
+        out.writeRaw<uint32_t>(num_events);
+        for (int event = 1; event <= num_events; event++) {
+            string name = eventName(event);
+            out.writeRaw<uint32_t>(name.size());
+            out.write(name);
+        }
+    }
+    
+    for (const Work& w : works) {
+        if (w.total_float > float_threshold) continue;
+        
+        switch (format) {
+        case OutputFormat::CSV:
+            writeCsvField(out, eventName(w.start));
+            out.write(',');
+            writeCsvField(out, eventName(w.end));
+            for (int value : {w.duration, w.t_early_start, w.t_early_finish,
+                              w.t_late_start, w.t_late_finish,
+                              w.total_float, w.free_float}) {
+                out.write(',');
+                out.writeInt(value);
+            }
+            out.write(w.total_float == 0 ? ",1\n" : ",0\n", 3);
+            break;
+        case OutputFormat::JSONL:
+            out.write("{\"start\":", 9);
+            writeJsonString(out, eventName(w.start));
+            out.write(",\"end\":", 7);
+            writeJsonString(out, eventName(w.end));
+            out.write(",\"duration\":", 12);
+            out.writeInt(w.duration);
+            out.write(",\"early_start\":", 15);
+            out.writeInt(w.t_early_start);
+            out.write(",\"early_finish\":", 16);
+            out.writeInt(w.t_early_finish);
+            out.write(",\"late_start\":", 14);
+            out.writeInt(w.t_late_start);
+            out.write(",\"late_finish\":", 15);
+            out.writeInt(w.t_late_finish);
+            out.write(",\"total_float\":", 15);
+            out.writeInt(w.total_float);
+            out.write(",\"free_float\":", 14);
+            out.writeInt(w.free_float);
+            if (w.total_float == 0) {
+                out.write(",\"critical\":true}\n", 18);
+            } else {
+                out.write(",\"critical\":false}\n", 19);
+            }
+            break;
+        case OutputFormat::Binary:
+            for (int value : {w.start, w.end, w.duration, w.t_early_start,
+                              w.t_early_finish, w.t_late_start, w.t_late_finish,
+                              w.total_float, w.free_float}) {
+                out.writeRaw<int32_t>(value);
+            }
+            break;
+        case OutputFormat::Table:
+            break;
+        }
+    }
+    return true;
+}
+
+// Критический подграф: индексы всех работ с нулевым полным резервом
+vector<int> NetworkGraph::criticalWorks() const {
+    vector<int> result;
+    for (size_t k = 0; k < works.size(); k++) {
+        if (works[k].total_float == 0) result.push_back(k);
+    }
+    return result;
+}
+
+// Все критические пути (обход в глубину по критическому подграфу).
+// Каждая ветвь обхода заканчивается в завершающем событии, поэтому
+// время работы O(V+E) плюс размер вывода. limit = 0 - без ограничения.
+vector<CriticalPath> NetworkGraph::findCriticalPaths(size_t limit) const {
+    vector<CriticalPath> paths;
+    if (works.empty()) return paths;
+    
+    int critical_time = criticalTime();
+    vector<vector<int>> critical_out(num_events + 1);
+    vector<bool> has_critical_in(num_events + 1, false);
+    for (int work_idx : criticalWorks()) {
+        critical_out[works[work_idx].start].push_back(work_idx);
+        has_critical_in[works[work_idx].end] = true;
+    }
+    
+    vector<int> path;
+    vector<size_t> next_edge;   // стек позиций обхода
+    for (int source = 1; source <= num_events; source++) {
+        if (critical_out[source].empty() || has_critical_in[source]) continue;
+        
+        path.assign(1, source);
+        next_edge.assign(1, 0);
+        while (!path.empty()) {
+            if (limit != 0 && paths.size() >= limit) return paths;
+            
+            int current = path.back();
+            if (critical_out[current].empty()) {
+                paths.push_back({critical_time, path});
+            }
+            if (next_edge.back() < critical_out[current].size()) {
+                const Work& w = works[critical_out[current][next_edge.back()++]];
+                path.push_back(w.end);
+                next_edge.push_back(0);
+            } else {
+                path.pop_back();
+                next_edge.pop_back();
+            }
+        }
+    }
+    return paths;
+}
+
+// k наиболее длинных (наиболее критических) путей от начальных событий
+// к завершающим. Динамика в обратном топологическом порядке: для каждого
+// события хранится до k лучших продолжений, O((V+E) k log k).
+vector<CriticalPath> NetworkGraph::findMostCriticalPaths(size_t k) const {
+    vector<CriticalPath> paths;
+    if (works.empty() || k == 0) return paths;
+    
+    // Продолжение пути: длина хвоста, работа и номер продолжения в её конце
+    struct Suffix {
+        int length;
+        int work_idx;
+        int rank;
+    };
+    vector<vector<Suffix>> best(num_events + 1);
+    
+    vector<int> order = topologicalOrder();
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        int event = *it;
+        if (outWorks(event).empty()) {
+            best[event].push_back({0, -1, -1});
+            continue;
+        }
+        
+        // Слияние упорядоченных списков потомков через очередь с приоритетом
+        priority_queue<pair<int, pair<int, int>>> heap;
+        for (int work_idx : outWorks(event)) {
+            const Work& w = works[work_idx];
+            heap.push({w.duration + best[w.end][0].length, {work_idx, 0}});
+        }
+        while (!heap.empty() && best[event].size() < k) {
+            auto [length, pos] = heap.top();
+            heap.pop();
+            auto [work_idx, rank] = pos;
+            best[event].push_back({length, work_idx, rank});
+            
+            const Work& w = works[work_idx];
+            if (rank + 1 < (int)best[w.end].size()) {
+                heap.push({w.duration + best[w.end][rank + 1].length,
+                           {work_idx, rank + 1}});
+            }
+        }
+    }
+    
+    // Общий список лучших путей по всем начальным событиям
+    priority_queue<pair<int, pair<int, int>>> heap;
+    for (int event = 1; event <= num_events; event++) {
+        if (inWorks(event).empty() && !outWorks(event).empty()) {
+            heap.push({best[event][0].length, {event, 0}});
+        }
+    }
+    while (!heap.empty() && paths.size() < k) {
+        auto [length, pos] = heap.top();
+        heap.pop();
+        auto [source, rank] = pos;
+        
+        CriticalPath path{length, {source}};
+        int event = source;
+        int r = rank;
+        while (best[event][r].work_idx != -1) {
+            const Suffix& s = best[event][r];
+            event = works[s.work_idx].end;
+            r = s.rank;
+            path.events.push_back(event);
+        }
+        paths.push_back(path);
+        
+        if (rank + 1 < (int)best[source].size()) {
+            heap.push({best[source][rank + 1].length, {source, rank + 1}});
+        }
+    }
+    return paths;
+}
+
+// Количество критических путей (динамика по топологическому порядку,
+// O(V+E)); при переполнении возвращается ULLONG_MAX
+unsigned long long NetworkGraph::countCriticalPaths() const {
+    vector<unsigned long long> count(num_events + 1, 0);
+    vector<bool> has_critical_in(num_events + 1, false);
+    vector<bool> has_critical_out(num_events + 1, false);
+    for (int work_idx : criticalWorks()) {
+        has_critical_out[works[work_idx].start] = true;
+        has_critical_in[works[work_idx].end] = true;
+    }
+    
+    unsigned long long total = 0;
+    for (int event : topologicalOrder()) {
+        if (has_critical_out[event] && !has_critical_in[event]) count[event] = 1;
+        if (count[event] == 0) continue;
+        if (!has_critical_out[event] && has_critical_in[event]) {
+            total = (total > ULLONG_MAX - count[event]) ? ULLONG_MAX : total + count[event];
+        }
+        for (int work_idx : outWorks(event)) {
+            const Work& w = works[work_idx];
+            if (w.total_float != 0) continue;
+            unsigned long long& c = count[w.end];
+            c = (c > ULLONG_MAX - count[event]) ? ULLONG_MAX : c + count[event];
+        }
+    }
+    return total;
+}
+
+// Поиск и вывод критических путей (не более max_paths)
+void NetworkGraph::findAndPrintCriticalPath(size_t max_paths) const {
+    vector<CriticalPath> paths = findCriticalPaths(max_paths);
+    
+    for (size_t p = 0; p < paths.size(); p++) {
+        if (p > 0) cout << endl << string(18, ' ');
+        const vector<int>& path = paths[p].events;
+        for (size_t i = 0; i < path.size(); i++) {
+            cout << eventName(path[i]);
+            if (i < path.size() - 1) cout << " -> ";
+        }
+    }
+    
+    unsigned long long total = countCriticalPaths();
+    if (total > paths.size()) {
+        cout << endl << string(18, ' ') << "... всего критических путей: ";
+        if (total == ULLONG_MAX) {
+            cout << "более " << ULLONG_MAX;
+        } else {
+            cout << total;
+        }
+    }
+}
+
+// Значения приоритета работ по правилу (меньше - раньше).
+// Требует предварительного вызова calculateAll().
+vector<double> NetworkGraph::priorities(PriorityRule rule) const {
+    vector<double> prio(works.size());
+    for (size_t k = 0; k < works.size(); k++) {
+        const Work& w = works[k];
+        switch (rule) {
+        case PriorityRule::LFT:      prio[k] = w.t_late_finish; break;
+        case PriorityRule::LST:      prio[k] = w.t_late_start; break;
+        case PriorityRule::MinSlack: prio[k] = w.total_float; break;
+        case PriorityRule::SPT:      prio[k] = w.duration; break;
+        case PriorityRule::GRPW: {
+            int weight = w.duration;
+            for (int next_idx : outWorks(w.end)) {
+                weight += works[next_idx].duration;
+            }
+            prio[k] = -weight;
+            break;
+        }
+        }
+    }
+    return prio;
+}
+
+// Параллельная схема генерации расписания: время продвигается по моментам
+// окончания работ (очередь по времени окончания), в каждый момент
+// допустимые работы запускаются в порядке приоритета, пока хватает ресурсов.
+// При max_misses > 0 просмотр очереди прекращается после max_misses не
+// поместившихся работ (эвристика: момент стоит O(max_misses), а не O(n)).
+// Работа допустима, когда завершены все работы, входящие в её начальное
+// событие, поэтому отношения предшествования хранятся по событиям.
+ResourceSchedule NetworkGraph::scheduleWithResources(const vector<double>& prio,
+                                                     int max_misses) const {
+    const int n = works.size();
+    const int r = resource_capacity.size();
+    ResourceSchedule result{-1, vector<int>(n, 0)};
+    
+    // Строка потребностей работы; работы, добавленные после задания
+    // потребностей (фиктивные), ресурсов не требуют
+    const vector<int> no_demand(r, 0);
+    auto demandOf = [&](int k) {
+        size_t row = static_cast<size_t>(k) * r;
+        return row + r <= work_demand.size() ? &work_demand[row] : no_demand.data();
+    };
+    for (int k = 0; k < n; k++) {
+        const int* d = demandOf(k);
+        for (int q = 0; q < r; q++) {
+            if (d[q] > resource_capacity[q]) {
+                cerr << "Ошибка: работа " << works[k].start << "-" << works[k].end
+                     << " требует больше ресурса " << q + 1 << ", чем доступно" << endl;
+                return result;
+            }
+        }
+    }
+    
+    vector<int> available = resource_capacity;
+    vector<int> remaining_in(num_events + 1);
+    for (int event = 1; event <= num_events; event++) {
+        remaining_in[event] = inWorks(event).size();
+    }
+    
+    using Item = pair<double, int>;
+    priority_queue<Item, vector<Item>, greater<Item>> eligible; // (приоритет, работа)
+    using Running = pair<int, int>;
+    priority_queue<Running, vector<Running>, greater<Running>> active; // (окончание, работа)
+    
+    for (int event = 1; event <= num_events; event++) {
+        if (remaining_in[event] == 0) {
+            for (int work_idx : outWorks(event)) eligible.push({prio[work_idx], work_idx});
+        }
+    }
+    
+    int t = 0;
+    int scheduled = 0;
+    vector<int> deferred;
+    while (scheduled < n) {
+        // Запуск допустимых работ в порядке приоритета
+        deferred.clear();
+        while (!eligible.empty() && (max_misses <= 0 || (int)deferred.size() < max_misses)) {
+            int k = eligible.top().second;
+            eligible.pop();
+            
+            const int* d = demandOf(k);
+            bool fits = true;
+            for (int q = 0; q < r; q++) {
+                if (d[q] > available[q]) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (!fits) {
+                deferred.push_back(k);
+                continue;
+            }
+            for (int q = 0; q < r; q++) available[q] -= d[q];
+            result.start[k] = t;
+            active.push({t + works[k].duration, k});
+            scheduled++;
+        }
+        for (int k : deferred) eligible.push({prio[k], k});
+        
+        if (active.empty()) {
+            if (scheduled < n) {
+                cerr << "Ошибка: не все работы достижимы из начальных событий" << endl;
+                return result;
+            }
+            break;
+        }
+        
+        // Переход к ближайшему моменту окончания
+        t = active.top().first;
+        while (!active.empty() && active.top().first == t) {
+            int k = active.top().second;
+            active.pop();
+            const int* d = demandOf(k);
+            for (int q = 0; q < r; q++) available[q] += d[q];
+            
+            int event = works[k].end;
+            if (--remaining_in[event] == 0) {
+                for (int work_idx : outWorks(event)) eligible.push({prio[work_idx], work_idx});
+            }
+        }
+    }
+    
+    result.makespan = 0;
+    for (int k = 0; k < n; k++) {
+        result.makespan = max(result.makespan, result.start[k] + works[k].duration);
+    }
+    return result;
+}
+
+// Локальный поиск по вектору приоритетов: обмен приоритетов двух
+// случайных работ и повторное построение расписания; изменение
+// принимается, если длительность проекта не ухудшилась.
+ResourceSchedule NetworkGraph::improveSchedule(vector<double> prio, int iterations,
+                                               unsigned seed) const {
+    ResourceSchedule best = scheduleWithResources(prio);
+    if (best.makespan < 0 || works.size() < 2) return best;
+    
+    mt19937 gen(seed);
+    uniform_int_distribution<int> pick(0, works.size() - 1);
+    for (int it = 0; it < iterations; it++) {
+        int a = pick(gen);
+        int b = pick(gen);
+        if (a == b || prio[a] == prio[b]) continue;
+        
+        swap(prio[a], prio[b]);
+        ResourceSchedule candidate = scheduleWithResources(prio);
+        if (candidate.makespan >= 0 && candidate.makespan <= best.makespan) {
+            best = move(candidate);
+        } else {
+            swap(prio[a], prio[b]);
+        }
+    }
+    return best;
+}
+
+// Вывод расписания с учетом ресурсов
+void NetworkGraph::printResourceSchedule(const ResourceSchedule& schedule) const {
+    if (schedule.makespan < 0) {
+        cout << "Расписание с учетом ресурсов не построено" << endl;
+        return;
+    }
+    
+    cout << "\n" << string(60, '=') << endl;
+    cout << "РАСПИСАНИЕ С УЧЕТОМ РЕСУРСОВ" << endl;
+    cout << string(60, '=') << endl;
+    cout << left << setw(10) << "Шифр" << setw(12) << "t(i,j)"
+         << setw(18) << "Начало" << setw(24) << "Окончание"
+         << "Сдвиг" << endl;
+    cout << string(60, '-') << endl;
+    
+    for (size_t k = 0; k < works.size(); k++) {
+        const Work& w = works[k];
+        cout << left << setw(10) << (eventName(w.start) + "-" + eventName(w.end))
+             << setw(12) << w.duration
+             << setw(12) << schedule.start[k]
+             << setw(15) << schedule.start[k] + w.duration
+             << schedule.start[k] - w.t_early_start << endl;
+    }
+    
+    cout << string(60, '-') << endl;
+    cout << "Длительность проекта с учетом ресурсов: " << schedule.makespan << endl;
+}
+
+// Вывод информации о графе
+void NetworkGraph::printGraphInfo() const {
+    cout << "\nИнформация о графе:" << endl;
+    cout << "Количество событий: " << num_events << endl;
+    cout << "Количество работ: " << works.size() << endl;
+    cout << "\nСписок работ:" << endl;
+    for (const Work& w : works) {
+        cout << eventName(w.start) << " -> " << eventName(w.end) << " : " << w.duration << endl;
+    }
+}
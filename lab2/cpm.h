@@ -0,0 +1,331 @@
+// Библиотека расчета параметров сетевого графика (метод критического пути).
+// Общий движок для всех вариантов программы lab2: загрузка сети из файла,
+// ранние и поздние сроки, резервы, критические пути, расписание с учетом
+// ресурсов и машиночитаемый вывод.
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Work {
+    int start;           // i - начало работы
+    int end;             // j - конец работы
+    int duration;        // tij - продолжительность
+    
+    // Временные параметры
+    int t_early_start;   // t^РН_ij - раннее начало
+    int t_early_finish;  // t^РО_ij - раннее окончание
+    int t_late_start;    // t^ПН_ij - позднее начало
+    int t_late_finish;   // t^ПО_ij - позднее окончание
+    int total_float;     // R_ij - полный резерв
+    int free_float;      // r_ij - свободный резерв
+    
+    // Параметры сокращения продолжительности (по умолчанию работа не сокращается)
+    int crash_duration;  // минимальная (срочная) продолжительность
+    double normal_cost;  // стоимость при нормальной продолжительности
+    double crash_cost;   // стоимость при срочной продолжительности
+    
+    Work(int i, int j, int d) : start(i), end(j), duration(d),
+                                t_early_start(0), t_early_finish(0),
+                                t_late_start(0), t_late_finish(0),
+                                total_float(0), free_float(0),
+                                crash_duration(d), normal_cost(0), crash_cost(0) {}
+};
+
+// Путь в сети: последовательность событий и его длина
+struct CriticalPath {
+    int length;               // суммарная продолжительность работ
+    std::vector<int> events;  // события от начального к завершающему
+};
+
+// Форматы вывода результатов расчета
+enum class OutputFormat {
+    Table,   // таблица для чтения человеком (printTable)
+    CSV,     // значения через запятую, строка заголовка
+    JSONL,   // один JSON-объект на строку
+    Binary   // двоичный поток записей фиксированного размера
+};
+
+// Буферизованная запись в файл или stdout ("-") с быстрым форматированием
+// целых чисел через std::to_chars, без iostream и setw
+class BufferedWriter {
+private:
+    FILE* out;
+    bool owns_file;
+    std::vector<char> buffer;
+    size_t used;
+    
+public:
+    explicit BufferedWriter(const std::string& filename, size_t capacity = 1 << 16)
+        : out(nullptr), owns_file(false), buffer(capacity), used(0) {
+        if (filename == "-") {
+            out = stdout;
+        } else {
+            out = fopen(filename.c_str(), "wb");
+            owns_file = true;
+        }
+    }
+    
+    ~BufferedWriter() {
+        flush();
+        if (owns_file && out) fclose(out);
+    }
+    
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+    
+    bool isOpen() const { return out != nullptr; }
+    
+    void flush() {
+        if (out && used > 0) fwrite(buffer.data(), 1, used, out);
+        used = 0;
+    }
+    
+    void write(const char* data, size_t size) {
+        if (used + size > buffer.size()) {
+            flush();
+            if (size > buffer.size()) {
+                fwrite(data, 1, size, out);
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+    }
+    
+    void write(const std::string& text) { write(text.data(), text.size()); }
+    
+    void write(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+    }
+    
+    void writeInt(long long value) {
+        if (used + 24 > buffer.size()) flush();
+        char* begin = buffer.data() + used;
+        used += std::to_chars(begin, begin + 24, value).ptr - begin;
+    }
+    
+    // Запись значения в двоичном виде (порядок байтов платформы)
+    template <typename T>
+    void writeRaw(const T& value) {
+        write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+};
+
+// Правила приоритета для построения расписания с ограниченными ресурсами
+enum class PriorityRule {
+    LFT,      // минимальное позднее окончание
+    LST,      // минимальное позднее начало
+    MinSlack, // минимальный полный резерв
+    SPT,      // кратчайшая продолжительность
+    GRPW      // наибольший вес позиции (работа + непосредственные последователи)
+};
+
+// Расписание с учетом ресурсов
+struct ResourceSchedule {
+    int makespan;             // длительность проекта (-1, если расписание не построено)
+    std::vector<int> start;   // время начала каждой работы
+};
+
+// Время выполнения этапов расчета, секунды
+struct CalculationTimes {
+    double validate = 0;  // проверка графа
+    double forward = 0;   // прямой проход (ранние сроки)
+    double backward = 0;  // обратный проход (поздние сроки)
+    double floats = 0;    // резервы времени
+};
+
+// Непрерывный диапазон индексов работ внутри CSR-массива
+struct WorkRange {
+    const int* first;
+    const int* last;
+    
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    int operator[](size_t k) const { return first[k]; }
+};
+
+// Сетевой график в форме "работы на дугах".
+// События нумеруются плотно от 1 до num_events; внешние идентификаторы
+// событий из файла хранятся в event_names и используются при выводе.
+class NetworkGraph {
+private:
+    int num_events;                            // количество событий
+    std::vector<Work> works;                   // список работ
+    std::vector<int> out_offset, out_works;    // исходящие работы событий (CSR)
+    std::vector<int> in_offset, in_works;      // входящие работы событий (CSR)
+    bool index_built;                          // CSR соответствует списку работ
+    std::vector<std::string> event_names;      // внешние идентификаторы событий (пусто - номер)
+    std::vector<int> resource_capacity;        // доступное количество ресурсов каждого типа
+    std::vector<int> work_demand;              // потребности работ, строка k - работа k (плоский n x r)
+    bool verbose;                              // вывод информационных сообщений в cout
+    
+    // Построение CSR по списку работ подсчетом степеней: два прохода и
+    // по одному непрерывному массиву на направление вместо вектора на событие
+    void buildIndex();
+    
+    // Поиск цикла среди событий, не попавших в топологический порядок
+    std::vector<int> findCycle(const std::vector<int>& order) const;
+    
+    // Добавление фиктивного события, возвращает его номер
+    int addEvent(const std::string& name);
+    
+    // Проверка на циклы и сведение к одному начальному и завершающему событию
+    bool validateGraph();
+    
+    // Прямой проход (ранние сроки)
+    void calculateEarlyTimes();
+    
+    // Обратный проход (поздние сроки)
+    void calculateLateTimes();
+    
+    // Расчет резервов времени
+    void calculateFloats();
+
+public:
+    NetworkGraph() : num_events(0), index_built(false), verbose(true) {}
+    
+    // Пустой граф с заданным числом событий для заполнения через addWork
+    explicit NetworkGraph(int events)
+        : num_events(events), index_built(false), verbose(true) {}
+    
+    // Отключение информационных сообщений (для машиночитаемого вывода в stdout)
+    void setVerbose(bool value) {
+        verbose = value;
+    }
+    
+    // Загрузка графа из файла формата "вершина предшественник вес [потребности]";
+    // строка "@R c1 c2 ..." задает объемы ресурсов, строка
+    // "@C вершина предшественник срочная_длит норм_стоимость срочная_стоимость" -
+    // параметры сокращения работы. Идентификаторы событий не начинаются с '@'
+    bool loadFromFile(const std::string& filename);
+    
+    // Загрузка с сохранением имен событий (совпадает с loadFromFile)
+    bool loadFromFileWithNames(const std::string& filename) {
+        return loadFromFile(filename);
+    }
+    
+    // Добавление работы между событиями с номерами 1..num_events. Связи
+    // событий строятся одним проходом при проверке графа (calculateAll)
+    void addWork(int i, int j, int duration);
+    
+    // Резервирование места под заданное число работ перед addWork
+    void reserveWorks(size_t count) {
+        works.reserve(count);
+    }
+    
+    // Установка имен событий
+    void setEventName(int event, const std::string& name);
+    
+    // Расчет всех параметров; при times != nullptr замеряется время этапов.
+    // Возвращает false, если работ нет или граф не прошел проверку (цикл)
+    bool calculateAll(CalculationTimes* times = nullptr);
+    
+    // Доступ к результатам расчета
+    const std::vector<Work>& getWorks() const { return works; }
+    int getNumEvents() const { return num_events; }
+    
+    // Длина критического пути (максимальное раннее окончание)
+    int criticalTime() const;
+    
+    // Имя события для вывода: внешний идентификатор или внутренний номер
+    std::string eventName(int event) const;
+    
+    // Топологический порядок событий (алгоритм Кана, O(V+E)); для графа
+    // с циклом содержит не все события. Этот и последующие методы требуют
+    // загрузки из файла или вызова calculateAll()
+    std::vector<int> topologicalOrder() const;
+    
+    // Исходящие и входящие работы события (индексы в getWorks())
+    WorkRange outWorks(int event) const {
+        return {out_works.data() + out_offset[event], out_works.data() + out_offset[event + 1]};
+    }
+    
+    WorkRange inWorks(int event) const {
+        return {in_works.data() + in_offset[event], in_works.data() + in_offset[event + 1]};
+    }
+    
+    // Вывод таблицы сетевого графика
+    void printTable() const;
+    
+    // Потоковая запись результатов в машиночитаемом формате; выводятся
+    // только работы с полным резервом <= float_threshold
+    bool writeResults(const std::string& filename, OutputFormat format,
+                      int float_threshold = INT_MAX) const;
+    
+    // Критический подграф: индексы всех работ с нулевым полным резервом
+    std::vector<int> criticalWorks() const;
+    
+    // Все критические пути за O(V+E) плюс размер вывода (limit = 0 - все)
+    std::vector<CriticalPath> findCriticalPaths(size_t limit = 0) const;
+    
+    // k наиболее длинных путей от начальных событий к завершающим
+    std::vector<CriticalPath> findMostCriticalPaths(size_t k) const;
+    
+    // Количество критических путей (ULLONG_MAX при переполнении)
+    unsigned long long countCriticalPaths() const;
+    
+    // Вывод критических путей (не более max_paths)
+    void findAndPrintCriticalPath(size_t max_paths = 10) const;
+    
+    // Установка объемов ресурсов и потребностей работ. Потребности задаются
+    // после объемов: строка работы имеет ширину resource_capacity, лишние
+    // значения отбрасываются; у работ без строки потребности нулевые
+    void setResourceCapacities(const std::vector<int>& capacities) {
+        resource_capacity = capacities;
+        work_demand.clear();
+    }
+    
+    void setWorkDemands(int work_idx, const std::vector<int>& demands) {
+        const size_t r = resource_capacity.size();
+        if (work_demand.size() < (work_idx + 1) * r) work_demand.resize(works.size() * r, 0);
+        size_t count = std::min(demands.size(), r);
+        std::copy(demands.begin(), demands.begin() + count, work_demand.begin() + work_idx * r);
+    }
+    
+    // Параметры сокращения работы (как строка "@C" во входном файле)
+    void setWorkCrash(int work_idx, int crash_duration, double normal_cost, double crash_cost) {
+        Work& w = works[work_idx];
+        w.crash_duration = std::min(crash_duration, w.duration);
+        w.normal_cost = normal_cost;
+        w.crash_cost = crash_cost;
+    }
+    
+    bool hasResources() const {
+        return !resource_capacity.empty();
+    }
+    
+    // Значения приоритета работ по правилу (меньше - раньше)
+    std::vector<double> priorities(PriorityRule rule) const;
+    
+    // Расписание с учетом ресурсов (параллельная схема генерации). По
+    // умолчанию в каждый момент просматриваются все допустимые работы.
+    // max_misses > 0 - эвристика для больших сетей: просмотр прекращается
+    // после max_misses не поместившихся работ, поэтому часть работ, которые
+    // поместились бы, откладывается и длительность может вырасти
+    ResourceSchedule scheduleWithResources(const std::vector<double>& prio,
+                                           int max_misses = 0) const;
+    
+    ResourceSchedule scheduleWithResources(PriorityRule rule) const {
+        return scheduleWithResources(priorities(rule));
+    }
+    
+    // Улучшение расписания локальным поиском по вектору приоритетов
+    ResourceSchedule improveSchedule(std::vector<double> prio, int iterations,
+                                     unsigned seed = 1) const;
+    
+    // Вывод расписания с учетом ресурсов
+    void printResourceSchedule(const ResourceSchedule& schedule) const;
+    
+    // Вывод информации о графе
+    void printGraphInfo() const;
+};
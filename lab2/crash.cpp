@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "cpm.h"
+#include "crashing.h"
+
+using namespace std;
+
+// Минимальная стоимость плана с длительностью не больше deadline полным
+// перебором целых продолжительностей работ (-1, если срок недостижим)
+static double bruteForceCost(const NetworkGraph& graph, int deadline) {
+    const vector<Work>& works = graph.getWorks();
+    const vector<int> order = graph.topologicalOrder();
+    vector<int> dur(works.size());
+    for (size_t k = 0; k < works.size(); k++) dur[k] = works[k].crash_duration;
+    
+    double best = -1;
+    while (true) {
+        vector<int> early(graph.getNumEvents() + 1, 0);
+        for (int event : order) {
+            for (size_t k = 0; k < works.size(); k++) {
+                if (works[k].start == event) {
+                    early[works[k].end] = max(early[works[k].end], early[event] + dur[k]);
+                }
+            }
+        }
+        if (*max_element(early.begin(), early.end()) <= deadline) {
+            double cost = 0;
+            for (size_t k = 0; k < works.size(); k++) {
+                const Work& w = works[k];
+                cost += w.normal_cost;
+                if (w.duration > w.crash_duration) {
+                    cost += (w.crash_cost - w.normal_cost) * (w.duration - dur[k])
+                            / (w.duration - w.crash_duration);
+                }
+            }
+            if (best < 0 || cost < best) best = cost;
+        }
+        
+        size_t k = 0;
+        while (k < works.size() && dur[k] == works[k].duration) {
+            dur[k] = works[k].crash_duration;
+            k++;
+        }
+        if (k == works.size()) break;
+        dur[k]++;
+    }
+    return best;
+}
+
+// Сравнение кривой с полным перебором на count случайных малых сетях;
+// возвращает число сетей с расхождением
+static int verify(int count, unsigned seed) {
+    mt19937 rng(seed);
+    auto uniform = [&](int lo, int hi) { return uniform_int_distribution<int>(lo, hi)(rng); };
+    int failures = 0;
+    for (int trial = 0; trial < count; trial++) {
+        // События 1..n: у каждого промежуточного есть вход от меньшего и
+        // выход к большему, остальные работы - случайные пары i < j
+        int n = uniform(3, 5);
+        vector<pair<int, int>> arcs;
+        auto add = [&](int i, int j) {
+            if (find(arcs.begin(), arcs.end(), make_pair(i, j)) == arcs.end()) arcs.push_back({i, j});
+        };
+        for (int event = 2; event < n; event++) {
+            add(uniform(1, event - 1), event);
+            add(event, uniform(event + 1, n));
+        }
+        add(1, n);
+        for (int extra = uniform(0, 3); extra > 0 && arcs.size() < 7; extra--) {
+            int i = uniform(1, n - 1);
+            add(i, uniform(i + 1, n));
+        }
+        
+        NetworkGraph graph(n);
+        graph.setVerbose(false);
+        for (auto [i, j] : arcs) graph.addWork(i, j, uniform(1, 5));
+        for (size_t k = 0; k < arcs.size(); k++) {
+            int duration = graph.getWorks()[k].duration;
+            double normal = uniform(0, 10);
+            graph.setWorkCrash(k, uniform(max(0, duration - 3), duration), normal,
+                               normal + uniform(0, 20));
+        }
+        if (!graph.calculateAll()) {
+            failures++;
+            continue;
+        }
+        
+        vector<TimeCostPoint> curve = timeCostCurve(graph);
+        for (int deadline = curve.back().duration - 1; deadline <= curve.front().duration; deadline++) {
+            TimeCostPlan plan;
+            double expected = bruteForceCost(graph, deadline);
+            bool reachable = scheduleForDeadline(graph, curve, deadline, plan);
+            if (reachable != (expected >= 0) || (reachable && fabs(plan.cost - expected) > 1e-6)) {
+                cout << "Сеть " << trial << ", срок " << deadline << ": стоимость "
+                     << (reachable ? plan.cost : -1) << ", перебор " << expected << endl;
+                failures++;
+                break;
+            }
+        }
+    }
+    cout << "Проверено сетей: " << count << ", расхождений: " << failures << endl;
+    return failures;
+}
+
+// Цепочка из count работ (около двадцати из них сокращаются): длинный критический
+// путь для проверки глубины обхода в максимальном потоке. Возвращает true,
+// если кривая дошла до суммы срочных продолжительностей по ожидаемой цене
+static bool verifyChain(int count) {
+    NetworkGraph graph(count + 1);
+    graph.setVerbose(false);
+    graph.reserveWorks(count);
+    for (int k = 0; k < count; k++) graph.addWork(k + 1, k + 2, 10);
+    int shortest = 0;
+    double cheapest = 0;
+    for (int k = 0; k < count; k++) {
+        bool crashable = k % (count / 20 + 1) == 0;
+        double crash_cost = 1 + k % 7;
+        graph.setWorkCrash(k, crashable ? 4 : 10, 1, crashable ? crash_cost : 1);
+        shortest += crashable ? 4 : 10;
+        cheapest += crashable ? crash_cost : 1;
+    }
+    if (!graph.calculateAll()) return false;
+    
+    vector<TimeCostPoint> curve = timeCostCurve(graph);
+    bool ok = curve.back().duration == shortest && fabs(curve.back().cost - cheapest) < 1e-6;
+    cout << "Цепочка из " << count << " работ: длительность " << curve.back().duration
+         << " (ожидалась " << shortest << "), стоимость " << curve.back().cost
+         << " (ожидалась " << cheapest << ")" << endl;
+    return ok;
+}
+
+// Оптимизация "время-стоимость":
+//   crash <файл> [директивный срок ...]
+// Без сроков выводится вся кривая минимальной стоимости.
+//   crash --verify [число сетей] [зерно]
+// сравнивает кривую с полным перебором на случайных малых сетях.
+//   crash --chain [число работ]
+// строит кривую для длинной цепочки работ.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Использование: " << argv[0] << " <файл> [директивный срок ...]" << endl;
+        return 1;
+    }
+    if (string(argv[1]) == "--verify") {
+        int count = argc > 2 ? stoi(argv[2]) : 1000;
+        unsigned seed = argc > 3 ? stoul(argv[3]) : 1;
+        return verify(count, seed) == 0 ? 0 : 1;
+    }
+    if (string(argv[1]) == "--chain") {
+        return verifyChain(argc > 2 ? stoi(argv[2]) : 200000) ? 0 : 1;
+    }
+    
+    NetworkGraph graph;
+    graph.setVerbose(false);
+    if (!graph.loadFromFile(argv[1]) || !graph.calculateAll()) return 1;
+    
+    vector<TimeCostPoint> curve = timeCostCurve(graph);
+    
+    if (argc == 2) {
+        cout << left << setw(26) << "Длительность" << "Стоимость" << endl;
+        for (const TimeCostPoint& point : curve) {
+            cout << left << setw(14) << point.duration << point.cost << endl;
+        }
+        return 0;
+    }
+    
+    const vector<Work>& works = graph.getWorks();
+    for (int i = 2; i < argc; i++) {
+        int deadline = stoi(argv[i]);
+        TimeCostPlan plan;
+        if (!scheduleForDeadline(graph, curve, deadline, plan)) {
+            cout << "Срок " << deadline << " недостижим (минимум "
+                 << curve.back().duration << ")" << endl;
+            continue;
+        }
+        cout << "\nСрок " << deadline << ": стоимость " << plan.cost << endl;
+        for (size_t k = 0; k < works.size(); k++) {
+            if (plan.durations[k] == works[k].duration) continue;
+            cout << "  " << graph.eventName(works[k].start) << "-"
+                 << graph.eventName(works[k].end) << ": " << works[k].duration
+                 << " -> " << plan.durations[k] << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,299 @@
+#include "crashing.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+namespace {
+
+const double INF = 1e18;
+const double EPS = 1e-9;
+
+// Максимальный поток методом Диница
+class MaxFlow {
+private:
+    struct Arc {
+        int to;
+        double capacity;
+    };
+    vector<Arc> arcs;              // дуга 2k - прямая, 2k+1 - обратная
+    vector<vector<int>> graph;
+    vector<int> level, next_arc;
+    vector<int> path;              // текущий путь поиска в глубину
+    
+    bool buildLevels(int source, int sink) {
+        fill(level.begin(), level.end(), -1);
+        queue<int> q;
+        level[source] = 0;
+        q.push(source);
+        while (!q.empty()) {
+            int v = q.front();
+            q.pop();
+            for (int a : graph[v]) {
+                if (arcs[a].capacity > EPS && level[arcs[a].to] < 0) {
+                    level[arcs[a].to] = level[v] + 1;
+                    q.push(arcs[a].to);
+                }
+            }
+        }
+        return level[sink] >= 0;
+    }
+    
+    // Один увеличивающий путь в слоистой сети. Поиск в глубину итеративный
+    // (длина пути доходит до числа событий): path - стек дуг от source,
+    // next_arc - текущая дуга каждой вершины, тупиковые дуги пропускаются
+    double augment(int source, int sink) {
+        path.clear();
+        int v = source;
+        while (v != sink) {
+            int& i = next_arc[v];
+            while (i < (int)graph[v].size()) {
+                const Arc& arc = arcs[graph[v][i]];
+                if (arc.capacity > EPS && level[arc.to] == level[v] + 1) break;
+                i++;
+            }
+            if (i < (int)graph[v].size()) {
+                path.push_back(graph[v][i]);
+                v = arcs[graph[v][i]].to;
+            } else {
+                if (path.empty()) return 0;
+                v = arcs[path.back() ^ 1].to;
+                path.pop_back();
+                next_arc[v]++;
+            }
+        }
+        
+        double pushed = INF;
+        for (int a : path) pushed = min(pushed, arcs[a].capacity);
+        for (int a : path) {
+            arcs[a].capacity -= pushed;
+            arcs[a ^ 1].capacity += pushed;
+        }
+        return pushed;
+    }
+    
+public:
+    explicit MaxFlow(int n) : graph(n), level(n), next_arc(n) {}
+    
+    // Возвращает номер прямой дуги
+    int addArc(int from, int to, double capacity) {
+        graph[from].push_back(arcs.size());
+        arcs.push_back({to, capacity});
+        graph[to].push_back(arcs.size());
+        arcs.push_back({from, 0});
+        return arcs.size() - 2;
+    }
+    
+    // Исключение дуги вместе с прошедшим по ней потоком
+    void removeArc(int arc) {
+        arcs[arc].capacity = 0;
+        arcs[arc ^ 1].capacity = 0;
+    }
+    
+    double run(int source, int sink) {
+        double flow = 0;
+        while (buildLevels(source, sink)) {
+            fill(next_arc.begin(), next_arc.end(), 0);
+            while (double pushed = augment(source, sink)) {
+                flow += pushed;
+                if (flow >= INF) return flow;
+            }
+        }
+        return flow;
+    }
+    
+    // Вершины, достижимые из source в остаточной сети (после run)
+    vector<bool> sourceSide(int source) const {
+        vector<bool> reached(graph.size(), false);
+        queue<int> q;
+        reached[source] = true;
+        q.push(source);
+        while (!q.empty()) {
+            int v = q.front();
+            q.pop();
+            for (int a : graph[v]) {
+                if (arcs[a].capacity > EPS && !reached[arcs[a].to]) {
+                    reached[arcs[a].to] = true;
+                    q.push(arcs[a].to);
+                }
+            }
+        }
+        return reached;
+    }
+};
+
+// Ранние и поздние сроки событий при заданных продолжительностях
+int eventTimes(const NetworkGraph& graph, const vector<int>& order,
+               const vector<int>& dur, vector<int>& early, vector<int>& late) {
+    const vector<Work>& works = graph.getWorks();
+    const int n = graph.getNumEvents();
+    
+    early.assign(n + 1, 0);
+    for (int event : order) {
+        for (int k : graph.outWorks(event)) {
+            early[works[k].end] = max(early[works[k].end], early[event] + dur[k]);
+        }
+    }
+    int project = *max_element(early.begin(), early.end());
+    
+    late.assign(n + 1, project);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        for (int k : graph.outWorks(*it)) {
+            late[*it] = min(late[*it], late[works[k].end] - dur[k]);
+        }
+    }
+    return project;
+}
+
+}  // namespace
+
+vector<TimeCostPoint> timeCostCurve(const NetworkGraph& graph) {
+    vector<TimeCostPoint> curve;
+    const vector<Work>& works = graph.getWorks();
+    const int n = graph.getNumEvents();
+    const size_t m = works.size();
+    if (m == 0) return curve;
+    
+    vector<int> order = graph.topologicalOrder();
+    vector<int> dur(m);
+    vector<double> slope(m, 0);
+    double cost = 0;
+    for (size_t k = 0; k < m; k++) {
+        const Work& w = works[k];
+        dur[k] = w.duration;
+        cost += w.normal_cost;
+        if (w.duration > w.crash_duration) {
+            slope[k] = (w.crash_cost - w.normal_cost) / (w.duration - w.crash_duration);
+        }
+    }
+    
+    // Начальное и завершающее события (граф проверен при загрузке)
+    int source = 0, sink = 0;
+    for (int event = 1; event <= n; event++) {
+        bool has_in = !graph.inWorks(event).empty(), has_out = !graph.outWorks(event).empty();
+        if (has_out && !has_in) source = event;
+        if (has_in && !has_out) sink = event;
+    }
+    
+    vector<int> early, late;
+    int project = eventTimes(graph, order, dur, early, late);
+    curve.push_back({project, cost, 0, {}, {}});
+    
+    while (true) {
+        // Сеть из критических работ с нижними границами потока: верхняя
+        // граница дуги - стоимость сокращения на единицу (бесконечность,
+        // если сокращать некуда), нижняя - экономия от удлинения ранее
+        // сокращенной работы. Стоимость разреза - сумма верхних границ
+        // прямых дуг минус сумма нижних границ обратных, минимальный разрез
+        // равен максимальному потоку с нижними границами.
+        MaxFlow flow(n + 3);
+        const int super_source = n + 1, super_sink = n + 2;
+        vector<size_t> critical;
+        vector<double> upper(m, 0), lower(m, 0), excess(n + 1, 0);
+        int min_float = numeric_limits<int>::max();
+        for (size_t k = 0; k < m; k++) {
+            const Work& w = works[k];
+            int total_float = late[w.end] - dur[k] - early[w.start];
+            if (total_float > 0) {
+                min_float = min(min_float, total_float);
+                continue;
+            }
+            critical.push_back(k);
+            upper[k] = dur[k] > w.crash_duration ? slope[k] : INF;
+            lower[k] = dur[k] < w.duration ? slope[k] : 0;
+            flow.addArc(w.start, w.end, upper[k] - lower[k]);
+            excess[w.end] += lower[k];
+            excess[w.start] -= lower[k];
+        }
+        
+        // Допустимый поток: нижние границы переносятся в избытки вершин,
+        // которые сбрасываются через дополнительные источник и сток при
+        // замкнутой дуге сток -> источник. Для оптимального текущего плана
+        // такой поток существует (иначе нашелся бы разрез отрицательной
+        // стоимости - удешевление без изменения длительности)
+        int back = flow.addArc(sink, source, INF);
+        double required = 0;
+        for (int event = 1; event <= n; event++) {
+            if (excess[event] > EPS) {
+                flow.addArc(super_source, event, excess[event]);
+                required += excess[event];
+            } else if (excess[event] < -EPS) {
+                flow.addArc(event, super_sink, -excess[event]);
+            }
+        }
+        if (flow.run(super_source, super_sink) < required - EPS * max(1.0, required)) break;
+        flow.removeArc(back);
+        
+        if (flow.run(source, sink) >= INF) break;   // критический путь больше не сокращается
+        vector<bool> side = flow.sourceSide(source);
+        
+        // Шаг сокращения: пока разрез не меняется и некритические пути
+        // не становятся критическими
+        int delta = min_float;
+        double cut = 0;
+        vector<int> shorten, lengthen;
+        for (size_t k : critical) {
+            const Work& w = works[k];
+            if (side[w.start] && !side[w.end]) {
+                shorten.push_back(k);
+                cut += upper[k];
+                delta = min(delta, dur[k] - w.crash_duration);
+            } else if (!side[w.start] && side[w.end] && lower[k] > 0) {
+                lengthen.push_back(k);
+                cut -= lower[k];
+                delta = min(delta, w.duration - dur[k]);
+            }
+        }
+        if (delta <= 0 || shorten.empty()) break;
+        
+        for (int k : shorten) dur[k] -= delta;
+        for (int k : lengthen) dur[k] += delta;
+        int next = eventTimes(graph, order, dur, early, late);
+        cost += cut * (project - next);
+        project = next;
+        curve.push_back({project, cost, delta, move(shorten), move(lengthen)});
+    }
+    return curve;
+}
+
+bool scheduleForDeadline(const NetworkGraph& graph, const vector<TimeCostPoint>& curve,
+                         int deadline, TimeCostPlan& result) {
+    if (curve.empty() || deadline < curve.back().duration) return false;
+    
+    const vector<Work>& works = graph.getWorks();
+    result.durations.resize(works.size());
+    for (size_t k = 0; k < works.size(); k++) result.durations[k] = works[k].duration;
+    if (deadline >= curve.front().duration) {
+        result.duration = curve.front().duration;
+        result.cost = curve.front().cost;
+        return true;
+    }
+    
+    // Кривая упорядочена по убыванию длительности; шаги до точки left
+    // применяются целиком
+    auto it = lower_bound(curve.begin(), curve.end(), deadline,
+                          [](const TimeCostPoint& p, int d) { return p.duration > d; });
+    auto apply = [&](const TimeCostPoint& point, int change) {
+        for (int k : point.shortened) result.durations[k] -= change;
+        for (int k : point.lengthened) result.durations[k] += change;
+    };
+    for (auto point = curve.begin() + 1; point != it; ++point) apply(*point, point->step);
+    const TimeCostPoint& right = *it;
+    if (right.duration == deadline) {
+        apply(right, right.step);
+        result.duration = deadline;
+        result.cost = right.cost;
+        return true;
+    }
+    const TimeCostPoint& left = *(it - 1);
+    
+    // Внутри отрезка разрез постоянен: продолжительности и стоимость линейны
+    int span = left.duration - right.duration;
+    int step = left.duration - deadline;
+    apply(right, right.step * step / span);
+    result.duration = deadline;
+    result.cost = left.cost + (right.cost - left.cost) * step / span;
+    return true;
+}
@@ -0,0 +1,40 @@
+// Оптимизация "время-стоимость" (сокращение продолжительности проекта).
+// Стоимость работы линейно растет от normal_cost при нормальной
+// продолжительности до crash_cost при срочной (crash_duration).
+#pragma once
+
+#include <vector>
+
+#include "cpm.h"
+
+// Точка излома кривой "время-стоимость". Продолжительности работ в точке
+// не хранятся: шаг от предыдущей точки сокращает работы shortened и
+// удлиняет работы lengthened на step, план восстанавливается по запросу
+struct TimeCostPoint {
+    int duration;                 // длительность проекта
+    double cost;                  // минимальная стоимость проекта
+    int step;                     // изменение продолжительностей на шаге
+    std::vector<int> shortened;   // работы, сокращенные на шаге
+    std::vector<int> lengthened;  // работы, удлиненные на шаге
+};
+
+// План для директивного срока
+struct TimeCostPlan {
+    int duration;                 // длительность проекта
+    double cost;                  // минимальная стоимость проекта
+    std::vector<int> durations;   // продолжительности работ
+};
+
+// Кривая минимальной стоимости от нормальной длительности проекта до
+// минимально достижимой. Каждый шаг - минимальный разрез критической сети
+// (алгоритм Филлипса - Дессуки, максимальный поток Диница). Шаг сокращения
+// максимален при неизменном разрезе, поэтому между соседними точками
+// стоимость и продолжительности работ меняются линейно.
+// Требует предварительного вызова calculateAll().
+std::vector<TimeCostPoint> timeCostCurve(const NetworkGraph& graph);
+
+// План для директивного срока по готовой кривой того же графа: шаги до
+// нужного отрезка применяются к нормальным продолжительностям, внутри
+// отрезка - интерполяция. Возвращает false, если срок недостижим.
+bool scheduleForDeadline(const NetworkGraph& graph, const std::vector<TimeCostPoint>& curve,
+                         int deadline, TimeCostPlan& result);
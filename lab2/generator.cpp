@@ -0,0 +1,26 @@
+#include <iostream>
+#include <string>
+
+#include "netgen.h"
+
+using namespace std;
+
+// Генерация сети в файл:
+//   generator <layered|sp|chain|fanout> <число работ> <файл> [seed]
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Использование: " << argv[0]
+             << " <layered|sp|chain|fanout> <число работ> <файл> [seed]" << endl;
+        return 1;
+    }
+    
+    NetworkShape shape;
+    if (!parseNetworkShape(argv[1], shape)) {
+        cerr << "Ошибка: неизвестная форма сети " << argv[1] << endl;
+        return 1;
+    }
+    long long num_works = stoll(argv[2]);
+    unsigned seed = (argc > 4) ? stoul(argv[4]) : 1;
+    
+    return generateNetwork(argv[3], shape, num_works, seed) ? 0 : 1;
+}
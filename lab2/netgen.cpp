@@ -0,0 +1,123 @@
+#include "netgen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cpm.h"
+
+using namespace std;
+
+namespace {
+
+// Строка файла: вершина предшественник вес
+void writeWork(BufferedWriter& out, long long pred, long long vertex, int duration) {
+    out.writeInt(vertex);
+    out.write(' ');
+    out.writeInt(pred);
+    out.write(' ');
+    out.writeInt(duration);
+    out.write('\n');
+}
+
+}  // namespace
+
+bool parseNetworkShape(const string& name, NetworkShape& shape) {
+    if (name == "layered") shape = NetworkShape::Layered;
+    else if (name == "sp") shape = NetworkShape::SeriesParallel;
+    else if (name == "chain") shape = NetworkShape::Chain;
+    else if (name == "fanout") shape = NetworkShape::FanOut;
+    else return false;
+    return true;
+}
+
+const char* networkShapeName(NetworkShape shape) {
+    switch (shape) {
+    case NetworkShape::Layered:        return "layered";
+    case NetworkShape::SeriesParallel: return "sp";
+    case NetworkShape::Chain:          return "chain";
+    case NetworkShape::FanOut:         return "fanout";
+    }
+    return "";
+}
+
+bool generateNetwork(const string& filename, NetworkShape shape,
+                     long long num_works, unsigned seed, int max_duration) {
+    BufferedWriter out(filename);
+    if (!out.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << endl;
+        return false;
+    }
+    
+    mt19937_64 gen(seed);
+    uniform_int_distribution<int> duration(1, max_duration);
+    num_works = max(num_works, 1LL);
+    
+    switch (shape) {
+    case NetworkShape::Layered: {
+        // Слои ширины ~sqrt(n); каждое событие слоя получает до трех работ
+        // от случайных событий предыдущего слоя. Событие 1 - начальное.
+        const long long width = max(1LL, (long long)sqrt((double)num_works));
+        const long long fan_in = min(3LL, width);
+        uniform_int_distribution<long long> pick(0, width - 1);
+        
+        long long written = 0;
+        long long prev_first = 2;
+        for (long long i = 0; i < width && written < num_works; i++, written++) {
+            writeWork(out, 1, prev_first + i, duration(gen));
+        }
+        while (written < num_works) {
+            long long first = prev_first + width;
+            for (long long i = 0; i < width && written < num_works; i++) {
+                for (long long k = 0; k < fan_in && written < num_works; k++, written++) {
+                    writeWork(out, prev_first + pick(gen), first + i, duration(gen));
+                }
+            }
+            prev_first = first;
+        }
+        break;
+    }
+    case NetworkShape::SeriesParallel: {
+        // Случайные последовательные и параллельные расщепления работ,
+        // начиная с одной работы 1 -> 2
+        vector<pair<long long, long long>> edges;
+        edges.reserve(num_works);
+        edges.push_back({1, 2});
+        long long next_event = 3;
+        bernoulli_distribution series(0.5);
+        while ((long long)edges.size() < num_works) {
+            uniform_int_distribution<size_t> pick(0, edges.size() - 1);
+            size_t e = pick(gen);
+            if (series(gen)) {
+                long long middle = next_event++;
+                edges.push_back({middle, edges[e].second});
+                edges[e].second = middle;
+            } else {
+                edges.push_back(edges[e]);
+            }
+        }
+        for (const auto& [from, to] : edges) {
+            writeWork(out, from, to, duration(gen));
+        }
+        break;
+    }
+    case NetworkShape::Chain:
+        for (long long i = 1; i <= num_works; i++) {
+            writeWork(out, i, i + 1, duration(gen));
+        }
+        break;
+    case NetworkShape::FanOut: {
+        long long middle = max(1LL, num_works / 2);
+        long long sink = middle + 2;
+        for (long long i = 0; i < middle; i++) {
+            writeWork(out, 1, i + 2, duration(gen));
+            writeWork(out, i + 2, sink, duration(gen));
+        }
+        break;
+    }
+    }
+    return true;
+}
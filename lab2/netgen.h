@@ -0,0 +1,23 @@
+// Генератор синтетических сетевых графиков для нагрузочного тестирования.
+// Сети записываются потоково в формате loadFromFile ("вершина предшественник вес").
+#pragma once
+
+#include <string>
+
+// Форма генерируемой сети
+enum class NetworkShape {
+    Layered,         // случайный слоистый DAG
+    SeriesParallel,  // последовательно-параллельная сеть
+    Chain,           // длинная цепочка работ
+    FanOut           // широкое ветвление: начало -> m событий -> конец
+};
+
+// Разбор и имя формы для командной строки и отчетов
+bool parseNetworkShape(const std::string& name, NetworkShape& shape);
+const char* networkShapeName(NetworkShape shape);
+
+// Запись случайной сети примерно из num_works работ в файл.
+// Продолжительности работ равномерно распределены на [1, max_duration].
+bool generateNetwork(const std::string& filename, NetworkShape shape,
+                     long long num_works, unsigned seed = 1,
+                     int max_duration = 100);
@@ -0,0 +1,363 @@
+#include "probability.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+// Носитель распределения с длиной не больше порога сворачивается напрямую
+const int DIRECT_CONVOLUTION_LIMIT = 64;
+
+// Входящие работы событий (CSR) и топологический порядок
+struct EventIndex {
+    vector<int> order;
+    vector<int> in_offset, in_works;
+    vector<int> out_degree;
+    
+    explicit EventIndex(const NetworkGraph& graph) : order(graph.topologicalOrder()) {
+        const int n = graph.getNumEvents();
+        const vector<Work>& works = graph.getWorks();
+        in_offset.assign(n + 2, 0);
+        out_degree.assign(n + 1, 0);
+        for (const Work& w : works) {
+            in_offset[w.end + 1]++;
+            out_degree[w.start]++;
+        }
+        for (int event = 0; event <= n; event++) in_offset[event + 1] += in_offset[event];
+        in_works.resize(works.size());
+        vector<int> pos(in_offset.begin(), in_offset.end() - 1);
+        for (size_t k = 0; k < works.size(); k++) in_works[pos[works[k].end]++] = k;
+    }
+};
+
+// Пул блоков одинакового размера для распределений сроков событий.
+// Блок освобождается, как только обработаны все работы, выходящие из
+// события, поэтому одновременно занято не больше блоков, чем ширина сети.
+class DistributionPool {
+private:
+    size_t block_size;
+    vector<double> storage;
+    vector<int> free_blocks;
+    
+public:
+    explicit DistributionPool(size_t size) : block_size(size) {}
+    
+    int acquire() {
+        if (free_blocks.empty()) {
+            free_blocks.push_back(storage.size() / block_size);
+            storage.resize(storage.size() + block_size);
+        }
+        int block = free_blocks.back();
+        free_blocks.pop_back();
+        return block;
+    }
+    
+    void release(int block) { free_blocks.push_back(block); }
+    
+    // Указатель действителен до следующего acquire()
+    double* data(int block) { return storage.data() + block * block_size; }
+};
+
+// Итеративное БПФ по основанию 2 (invert - обратное преобразование)
+void fft(vector<complex<double>>& a, bool invert) {
+    const size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) swap(a[i], a[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        double angle = 2 * M_PI / len * (invert ? -1 : 1);
+        complex<double> root(cos(angle), sin(angle));
+        for (size_t i = 0; i < n; i += len) {
+            complex<double> w(1);
+            for (size_t j = 0; j < len / 2; j++) {
+                complex<double> u = a[i + j], v = a[i + j + len / 2] * w;
+                a[i + j] = u + v;
+                a[i + j + len / 2] = u - v;
+                w *= root;
+            }
+        }
+    }
+    if (invert) {
+        for (complex<double>& x : a) x /= n;
+    }
+}
+
+// Свертка a (длина na) и b (длина nb) в out (длина na + nb - 1)
+class Convolver {
+private:
+    vector<complex<double>> fa, fb;  // переиспользуемые буферы БПФ
+    
+public:
+    void convolve(const double* a, int na, const double* b, int nb, double* out) {
+        const int size = na + nb - 1;
+        if (min(na, nb) <= DIRECT_CONVOLUTION_LIMIT) {
+            fill(out, out + size, 0.0);
+            for (int i = 0; i < na; i++) {
+                if (a[i] == 0) continue;
+                for (int j = 0; j < nb; j++) out[i + j] += a[i] * b[j];
+            }
+            return;
+        }
+        
+        size_t n = 1;
+        while (n < (size_t)size) n <<= 1;
+        fa.assign(n, 0);
+        fb.assign(n, 0);
+        for (int i = 0; i < na; i++) fa[i] = a[i];
+        for (int j = 0; j < nb; j++) fb[j] = b[j];
+        fft(fa, false);
+        fft(fb, false);
+        for (size_t i = 0; i < n; i++) fa[i] *= fb[i];
+        fft(fa, true);
+        // Погрешность БПФ может дать малые отрицательные значения
+        for (int i = 0; i < size; i++) out[i] = max(0.0, fa[i].real());
+    }
+};
+
+// Наибольшее значение распределения
+int maxValue(const DiscreteDistribution& d) {
+    return d.offset + (int)d.prob.size() - 1;
+}
+
+// Точка распределения "значение:вероятность"; обе части разбираются целиком
+bool parsePoint(const string& token, int& value, double& p) {
+    size_t colon = token.find(':');
+    if (colon == string::npos) return false;
+    const char* begin = token.data();
+    const char* middle = begin + colon;
+    const char* end = begin + token.size();
+    auto [value_end, value_error] = from_chars(begin, middle, value);
+    if (value_error != errc() || value_end != middle) return false;
+    auto [p_end, p_error] = from_chars(middle + 1, end, p);
+    return p_error == errc() && p_end == end;
+}
+
+}  // namespace
+
+bool loadDurationDistributions(const NetworkGraph& graph, const string& filename,
+                               vector<DiscreteDistribution>& distributions) {
+    const vector<Work>& works = graph.getWorks();
+    distributions.assign(works.size(), DiscreteDistribution());
+    for (size_t k = 0; k < works.size(); k++) {
+        distributions[k].offset = works[k].duration;
+        distributions[k].prob.assign(1, 1.0);
+    }
+    
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << endl;
+        return false;
+    }
+    
+    // Работы по паре имен событий; предшественник "0" - фиктивное начало
+    unordered_map<string, int> event_index;
+    for (int event = 1; event <= graph.getNumEvents(); event++) {
+        event_index.emplace(graph.eventName(event), event);
+    }
+    unordered_map<long long, int> work_index;
+    for (size_t k = 0; k < works.size(); k++) {
+        work_index.try_emplace((long long)works[k].start << 32 | works[k].end, k);
+    }
+    
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        
+        istringstream iss(line);
+        string vertex_id, pred_id;
+        if (!(iss >> vertex_id >> pred_id)) continue;
+        if (pred_id == "0") pred_id = "(начало)";
+        
+        auto from = event_index.find(pred_id);
+        auto to = event_index.find(vertex_id);
+        auto it = work_index.end();
+        if (from != event_index.end() && to != event_index.end()) {
+            it = work_index.find((long long)from->second << 32 | to->second);
+        }
+        if (it == work_index.end()) {
+            cerr << "Ошибка: распределение для несуществующей работы "
+                 << pred_id << "-" << vertex_id << endl;
+            return false;
+        }
+        
+        vector<pair<int, double>> points;
+        string token;
+        while (iss >> token) {
+            int value;
+            double p;
+            if (!parsePoint(token, value, p)) {
+                cerr << "Ошибка: ожидалось значение:вероятность, получено " << token << endl;
+                return false;
+            }
+            if (value < 0 || p < 0) {
+                cerr << "Ошибка: отрицательное значение в " << token << endl;
+                return false;
+            }
+            points.push_back(make_pair(value, p));
+        }
+        
+        double total = 0;
+        for (const auto& point : points) total += point.second;
+        if (points.empty() || total <= 0) {
+            cerr << "Ошибка: пустое распределение для работы "
+                 << pred_id << "-" << vertex_id << endl;
+            return false;
+        }
+        
+        int lo = points[0].first, hi = points[0].first;
+        for (const auto& point : points) {
+            lo = min(lo, point.first);
+            hi = max(hi, point.first);
+        }
+        DiscreteDistribution& d = distributions[it->second];
+        d.offset = lo;
+        d.prob.assign(hi - lo + 1, 0.0);
+        for (const auto& point : points) d.prob[point.first - lo] += point.second / total;
+    }
+    return true;
+}
+
+vector<double> completionTimeCdf(const NetworkGraph& graph,
+                                 const vector<DiscreteDistribution>& distributions) {
+    const int n = graph.getNumEvents();
+    const vector<Work>& works = graph.getWorks();
+    EventIndex index(graph);
+    
+    // Носитель срока события [lo, hi]: пути из минимальных и максимальных
+    // продолжительностей; горизонт - наибольший возможный срок проекта
+    vector<int> lo(n + 1, 0), hi(n + 1, 0);
+    for (int event : index.order) {
+        for (int q = index.in_offset[event]; q < index.in_offset[event + 1]; q++) {
+            int k = index.in_works[q];
+            lo[event] = max(lo[event], lo[works[k].start] + distributions[k].offset);
+            hi[event] = max(hi[event], hi[works[k].start] + maxValue(distributions[k]));
+        }
+    }
+    int horizon = 0;
+    for (int event = 1; event <= n; event++) horizon = max(horizon, hi[event]);
+    
+    // Распределения событий хранятся в блоках пула длины horizon + 1,
+    // значение для срока t - в элементе t
+    DistributionPool pool(horizon + 1);
+    Convolver convolver;
+    vector<int> block(n + 1, -1);
+    vector<int> remaining = index.out_degree;
+    vector<double> sum(horizon + 1), cdf(horizon + 1);
+    vector<double> project(horizon + 1, 1.0);
+    
+    for (int event : index.order) {
+        int b = pool.acquire();
+        double* pmf = pool.data(b);
+        
+        if (index.in_offset[event] == index.in_offset[event + 1]) {
+            pmf[0] = 1.0;  // начальное событие наступает в момент 0
+        } else {
+            // Максимум сумм по входящим работам: произведение функций распределения
+            fill(cdf.begin() + lo[event], cdf.begin() + hi[event] + 1, 1.0);
+            for (int q = index.in_offset[event]; q < index.in_offset[event + 1]; q++) {
+                int k = index.in_works[q];
+                int from = works[k].start;
+                const DiscreteDistribution& d = distributions[k];
+                const double* source = pool.data(block[from]);
+                
+                int width = hi[from] - lo[from] + 1;
+                int sum_lo = lo[from] + d.offset;
+                int sum_hi = sum_lo + width + (int)d.prob.size() - 2;
+                convolver.convolve(source + lo[from], width, d.prob.data(), d.prob.size(),
+                                   sum.data() + sum_lo);
+                
+                double acc = 0;
+                for (int t = sum_lo; t < lo[event]; t++) acc += sum[t];
+                for (int t = lo[event]; t <= min(sum_hi, hi[event]); t++) {
+                    acc += sum[t];
+                    cdf[t] *= min(acc, 1.0);
+                }
+                
+                if (--remaining[from] == 0) pool.release(block[from]);
+            }
+            double previous = 0;
+            for (int t = lo[event]; t <= hi[event]; t++) {
+                pmf[t] = max(0.0, cdf[t] - previous);
+                previous = cdf[t];
+            }
+        }
+        block[event] = b;
+        
+        // Завершающее событие входит в срок проекта
+        if (index.out_degree[event] == 0) {
+            double acc = 0;
+            for (int t = 0; t <= horizon; t++) {
+                if (t >= lo[event] && t <= hi[event]) acc += pmf[t];
+                project[t] *= min(acc, 1.0);
+            }
+            pool.release(b);
+        }
+    }
+    return project;
+}
+
+vector<double> simulateCompletionTimeCdf(const NetworkGraph& graph,
+                                         const vector<DiscreteDistribution>& distributions,
+                                         int iterations, unsigned seed) {
+    const int n = graph.getNumEvents();
+    const vector<Work>& works = graph.getWorks();
+    EventIndex index(graph);
+    
+    // Накопленные вероятности для выборки обратным преобразованием
+    vector<vector<double>> cumulative(works.size());
+    int horizon = 0;
+    vector<int> hi(n + 1, 0);
+    for (int event : index.order) {
+        for (int q = index.in_offset[event]; q < index.in_offset[event + 1]; q++) {
+            int k = index.in_works[q];
+            hi[event] = max(hi[event], hi[works[k].start] + maxValue(distributions[k]));
+        }
+        horizon = max(horizon, hi[event]);
+    }
+    for (size_t k = 0; k < works.size(); k++) {
+        partial_sum(distributions[k].prob.begin(), distributions[k].prob.end(),
+                    back_inserter(cumulative[k]));
+    }
+    
+    mt19937 rng(seed);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    vector<long long> histogram(horizon + 1, 0);
+    vector<int> time(n + 1);
+    
+    for (int it = 0; it < iterations; it++) {
+        int finish = 0;
+        for (int event : index.order) {
+            time[event] = 0;
+            for (int q = index.in_offset[event]; q < index.in_offset[event + 1]; q++) {
+                int k = index.in_works[q];
+                const vector<double>& c = cumulative[k];
+                int pos = upper_bound(c.begin(), c.end() - 1, uniform(rng) * c.back()) - c.begin();
+                time[event] = max(time[event], time[works[k].start] + distributions[k].offset + pos);
+            }
+            finish = max(finish, time[event]);
+        }
+        histogram[finish]++;
+    }
+    
+    vector<double> cdf(horizon + 1);
+    long long acc = 0;
+    for (int t = 0; t <= horizon; t++) {
+        acc += histogram[t];
+        cdf[t] = (double)acc / max(iterations, 1);
+    }
+    return cdf;
+}
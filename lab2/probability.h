@@ -0,0 +1,35 @@
+// Вероятностный расчет срока завершения проекта для работ с дискретными
+// распределениями продолжительности.
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cpm.h"
+
+// Дискретное распределение продолжительности: P(X = offset + k) = prob[k]
+struct DiscreteDistribution {
+    int offset;
+    std::vector<double> prob;
+};
+
+// Загрузка распределений из файла строк "вершина предшественник v1:p1 v2:p2 ..."
+// (пары событий как в файле графа). Работы, не упомянутые в файле, получают
+// вырожденное распределение в точке своей продолжительности.
+bool loadDurationDistributions(const NetworkGraph& graph, const std::string& filename,
+                               std::vector<DiscreteDistribution>& distributions);
+
+// Функция распределения срока завершения проекта: cdf[t] = P(T <= t).
+// Распределения сроков событий распространяются в топологическом порядке:
+// сумма - свертка (через БПФ для длинных носителей), максимум - произведение
+// функций распределения. Сроки входящих в событие путей считаются
+// независимыми, поэтому при общих предшественниках результат приближенный
+// (оценка вероятности уложиться в срок снизу).
+// Требует предварительного вызова calculateAll().
+std::vector<double> completionTimeCdf(const NetworkGraph& graph,
+                                      const std::vector<DiscreteDistribution>& distributions);
+
+// Та же функция распределения, оцененная методом Монте-Карло
+std::vector<double> simulateCompletionTimeCdf(const NetworkGraph& graph,
+                                              const std::vector<DiscreteDistribution>& distributions,
+                                              int iterations, unsigned seed = 1);
@@ -0,0 +1,127 @@
+#include "schedule_query.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+long long workKey(int start, int end) {
+    return (long long)start << 32 | (unsigned)end;
+}
+
+// Общий счетчик версий всех сервисов (0 - кэш потока пуст)
+atomic<uint64_t> next_version(1);
+
+uint64_t newVersion() {
+    return next_version.fetch_add(1, memory_order_relaxed);
+}
+
+}  // namespace
+
+shared_ptr<const ScheduleSnapshot> ScheduleSnapshot::build(const NetworkGraph& graph) {
+    shared_ptr<ScheduleSnapshot> s(new ScheduleSnapshot());
+    const int n = graph.getNumEvents();
+    s->works = graph.getWorks();
+    s->critical_time = graph.criticalTime();
+    
+    s->event_ids.resize(n + 1);
+    s->event_index.reserve(n);
+    for (int event = 1; event <= n; event++) {
+        s->event_ids[event] = graph.eventName(event);
+        s->event_index.emplace(s->event_ids[event], event);
+    }
+    
+    s->event_early.assign(n + 1, 0);
+    s->succ_offset.assign(n + 2, 0);
+    for (const Work& w : s->works) {
+        s->event_early[w.end] = max(s->event_early[w.end], w.t_early_finish);
+        s->succ_offset[w.start + 1]++;
+    }
+    for (int event = 0; event <= n; event++) {
+        s->succ_offset[event + 1] += s->succ_offset[event];
+    }
+    s->succ_works.resize(s->works.size());
+    vector<int> pos(s->succ_offset.begin(), s->succ_offset.end() - 1);
+    s->work_index.reserve(s->works.size());
+    for (size_t k = 0; k < s->works.size(); k++) {
+        const Work& w = s->works[k];
+        s->succ_works[pos[w.start]++] = k;
+        s->work_index.try_emplace(workKey(w.start, w.end), k);
+    }
+    
+    s->by_float.resize(s->works.size());
+    for (size_t k = 0; k < s->works.size(); k++) s->by_float[k] = k;
+    stable_sort(s->by_float.begin(), s->by_float.end(), [&](int a, int b) {
+        return s->works[a].total_float < s->works[b].total_float;
+    });
+    return s;
+}
+
+int ScheduleSnapshot::findEvent(const string& id) const {
+    auto it = event_index.find(id);
+    return it == event_index.end() ? -1 : it->second;
+}
+
+int ScheduleSnapshot::findWork(const string& start, const string& end) const {
+    int from = findEvent(start);
+    int to = findEvent(end);
+    if (from < 0 || to < 0) return -1;
+    auto it = work_index.find(workKey(from, to));
+    return it == work_index.end() ? -1 : it->second;
+}
+
+vector<int> ScheduleSnapshot::downstreamEvents(int event) const {
+    vector<int> result;
+    vector<bool> visited(event_ids.size(), false);
+    visited[event] = true;
+    
+    vector<int> stack = {event};
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        for (int q = succ_offset[current]; q < succ_offset[current + 1]; q++) {
+            int next = works[succ_works[q]].end;
+            if (!visited[next]) {
+                visited[next] = true;
+                result.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+    return result;
+}
+
+vector<int> ScheduleSnapshot::nearCritical(int threshold) const {
+    auto end = upper_bound(by_float.begin(), by_float.end(), threshold,
+                           [&](int value, int k) { return value < works[k].total_float; });
+    return vector<int>(by_float.begin(), end);
+}
+
+ScheduleQueryService::ScheduleQueryService() : version(newVersion()) {}
+
+void ScheduleQueryService::publish(const NetworkGraph& graph) {
+    atomic_store(&current, ScheduleSnapshot::build(graph));
+    version.store(newVersion(), memory_order_release);
+}
+
+const ScheduleSnapshot* ScheduleQueryService::snapshot() const {
+    // Версия однозначно определяет сервис и его снимок, поэтому адрес
+    // сервиса в ключе кэша не нужен
+    struct Cache {
+        uint64_t version = 0;
+        shared_ptr<const ScheduleSnapshot> snapshot;
+    };
+    thread_local Cache cache;
+    
+    uint64_t now = version.load(memory_order_acquire);
+    if (cache.version != now) {
+        cache.snapshot = atomic_load(&current);
+        cache.version = now;
+    }
+    return cache.snapshot.get();
+}
+
+shared_ptr<const ScheduleSnapshot> ScheduleQueryService::acquire() const {
+    return atomic_load(&current);
+}
@@ -0,0 +1,79 @@
+// Многопоточные запросы к рассчитанному сетевому графику.
+// Читатели работают с неизменяемым снимком расписания; пересчет публикует
+// новый снимок заменой указателя, а старый освобождается, когда его
+// отпустит последний читатель.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cpm.h"
+
+// Неизменяемый снимок расписания
+class ScheduleSnapshot {
+private:
+    std::vector<Work> works;
+    std::vector<std::string> event_ids;            // индекс 0 не используется
+    std::vector<int> event_early;                  // ранний срок события
+    std::vector<int> succ_offset, succ_works;      // исходящие работы (CSR)
+    std::vector<int> by_float;                     // работы по возрастанию полного резерва
+    std::unordered_map<std::string, int> event_index;
+    std::unordered_map<long long, int> work_index; // (начало, конец) -> работа
+    int critical_time;
+    
+    ScheduleSnapshot() : critical_time(0) {}
+
+public:
+    // Снимок рассчитанного графа (после calculateAll)
+    static std::shared_ptr<const ScheduleSnapshot> build(const NetworkGraph& graph);
+    
+    int numEvents() const { return (int)event_ids.size() - 1; }
+    const std::vector<Work>& getWorks() const { return works; }
+    const std::string& eventId(int event) const { return event_ids[event]; }
+    int criticalTime() const { return critical_time; }
+    
+    // Номер события или работы по идентификаторам из файла (-1, если нет)
+    int findEvent(const std::string& id) const;
+    int findWork(const std::string& start, const std::string& end) const;
+    
+    // Ранний срок наступления события
+    int earliestStart(int event) const { return event_early[event]; }
+    
+    // События, достижимые из заданного (без него самого)
+    std::vector<int> downstreamEvents(int event) const;
+    
+    // Работы с полным резервом <= threshold, по возрастанию резерва
+    std::vector<int> nearCritical(int threshold) const;
+};
+
+// Сервис запросов: хранит текущий снимок и номер его версии. Номера версий
+// берутся из общего для всех сервисов счетчика, поэтому не повторяются ни у
+// одного экземпляра - даже созданного по адресу уничтоженного.
+class ScheduleQueryService {
+private:
+    std::shared_ptr<const ScheduleSnapshot> current;
+    std::atomic<uint64_t> version;
+
+public:
+    ScheduleQueryService();
+    
+    // Публикация нового расписания (после пересчета графа)
+    void publish(const NetworkGraph& graph);
+    
+    // Текущий снимок. Поток кэширует снимок и сверяет только атомарный
+    // номер версии, так что в отсутствие пересчетов чтение не берет
+    // блокировок и не меняет счетчиков ссылок. Указатель действителен до
+    // следующего вызова snapshot() в этом же потоке (nullptr - расписание
+    // еще не опубликовано). Кэш потока (thread_local, один слот) владеет
+    // последним полученным снимком, поэтому снимок живет в памяти и после
+    // публикации нового, пока этот поток снова не вызовет snapshot().
+    const ScheduleSnapshot* snapshot() const;
+    
+    // Текущий снимок во владение - для хранения дольше одного запроса
+    // (атомарно увеличивает общий счетчик ссылок)
+    std::shared_ptr<const ScheduleSnapshot> acquire() const;
+};
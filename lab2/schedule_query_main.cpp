@@ -0,0 +1,149 @@
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpm.h"
+#include "schedule_query.h"
+
+using namespace std;
+
+// Целое число, строка разбирается целиком
+bool parseInt(const string& text, int& value) {
+    auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    return error == errc() && end == text.data() + text.size();
+}
+
+// Загрузка и расчет графа с публикацией нового снимка
+bool reload(ScheduleQueryService& service, const string& filename) {
+    NetworkGraph graph;
+    graph.setVerbose(false);
+    if (!graph.loadFromFile(filename) || !graph.calculateAll()) return false;
+    service.publish(graph);
+    return true;
+}
+
+// Нагрузочная проверка: читатели выполняют запросы, пока основной поток
+// пересчитывает график и публикует снимки
+int runBench(ScheduleQueryService& service, const string& filename,
+             int readers, int reloads) {
+    atomic<bool> stop(false);
+    vector<unsigned long long> counts(readers, 0);
+    vector<thread> threads;
+    
+    auto begin = chrono::steady_clock::now();
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            unsigned long long done = 0;
+            unsigned state = r * 2654435761u + 1;
+            while (!stop.load(memory_order_relaxed)) {
+                const ScheduleSnapshot* snap = service.snapshot();
+                const vector<Work>& works = snap->getWorks();
+                if (works.empty()) continue;
+                state = state * 1664525u + 1013904223u;
+                const Work& w = works[state % works.size()];
+                int found = snap->findWork(snap->eventId(w.start), snap->eventId(w.end));
+                volatile int sink = snap->getWorks()[found].total_float
+                                    + snap->earliestStart(w.start)
+                                    + (int)snap->nearCritical(0).size();
+                (void)sink;
+                done++;
+            }
+            counts[r] = done;
+        });
+    }
+    
+    for (int i = 0; i < reloads; i++) {
+        if (!reload(service, filename)) break;
+    }
+    this_thread::sleep_for(chrono::milliseconds(200));
+    stop = true;
+    for (thread& t : threads) t.join();
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    unsigned long long total = 0;
+    for (unsigned long long c : counts) total += c;
+    cout << "Читателей: " << readers << ", пересчетов: " << reloads
+         << ", запросов: " << total << " (" << (long long)(total / seconds)
+         << " в секунду)" << endl;
+    return 0;
+}
+
+// Запросы к рассчитанному сетевому графику:
+//   schedule_query <файл>                     - команды со стандартного ввода
+//   schedule_query <файл> --bench N [пересчеты] - N потоков-читателей
+// Команды: float <i> <j>, start <событие>, down <событие>, near <резерв>,
+// reload, quit
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Использование: " << argv[0] << " <файл> [--bench N [пересчеты]]" << endl;
+        return 1;
+    }
+    
+    string filename = argv[1];
+    ScheduleQueryService service;
+    if (!reload(service, filename)) return 1;
+    
+    if (argc >= 4 && string(argv[2]) == "--bench") {
+        int readers, reloads = 10;
+        if (!parseInt(argv[3], readers) || readers < 1 || (argc >= 5 && !parseInt(argv[4], reloads))) {
+            cerr << "Ошибка: неверное число потоков или пересчетов" << endl;
+            return 1;
+        }
+        return runBench(service, filename, readers, reloads);
+    }
+    
+    string line;
+    while (getline(cin, line)) {
+        istringstream in(line);
+        string command, a, b;
+        in >> command >> a >> b;
+        if (command.empty()) continue;
+        if (command == "quit") break;
+        
+        shared_ptr<const ScheduleSnapshot> snap = service.acquire();
+        if (command == "reload") {
+            if (reload(service, filename)) cout << "Расписание пересчитано" << endl;
+        } else if (command == "float") {
+            int k = snap->findWork(a, b);
+            if (k < 0) {
+                cout << "Работа " << a << "-" << b << " не найдена" << endl;
+                continue;
+            }
+            const Work& w = snap->getWorks()[k];
+            cout << "R = " << w.total_float << ", r = " << w.free_float << endl;
+        } else if (command == "start" || command == "down") {
+            int event = snap->findEvent(a);
+            if (event < 0) {
+                cout << "Событие " << a << " не найдено" << endl;
+                continue;
+            }
+            if (command == "start") {
+                cout << "Ранний срок: " << snap->earliestStart(event) << endl;
+            } else {
+                for (int next : snap->downstreamEvents(event)) {
+                    cout << snap->eventId(next) << " ";
+                }
+                cout << endl;
+            }
+        } else if (command == "near") {
+            int threshold = 0;
+            if (!a.empty() && !parseInt(a, threshold)) {
+                cout << "Неверный резерв: " << a << endl;
+                continue;
+            }
+            for (int k : snap->nearCritical(threshold)) {
+                const Work& w = snap->getWorks()[k];
+                cout << snap->eventId(w.start) << "-" << snap->eventId(w.end)
+                     << " R = " << w.total_float << endl;
+            }
+        } else {
+            cout << "Неизвестная команда: " << command << endl;
+        }
+    }
+    return 0;
+}
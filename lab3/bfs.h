@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "csr_graph.h"
+#include "parallel.h"
+
+// BFS с переключением направления (Beamer): пока фронт мал, соседи
+// просматриваются сверху вниз от вершин фронта; когда ребер фронта становится
+// больше, чем ребер непосещенных вершин / ALPHA, каждая непосещенная вершина
+// сама ищет соседа во фронте (снизу вверх) и останавливается на первом.
+// Фронт снизу вверх хранится битовой картой. Уровни обрабатываются
+// параллельно; при малом фронте - в одном потоке.
+class BFSEngine {
+private:
+    static constexpr int ALPHA = 14;
+    static constexpr int BETA = 24;
+    static constexpr size_t TOP_DOWN_CHUNK = 256;
+    static constexpr int SAMPLES = 256;
+    
+    const CSRGraph& g;
+    int threads;
+    std::vector<std::atomic<std::uint64_t>> visited;
+    std::vector<std::uint64_t> frontierBits, nextBits;
+    std::vector<int> frontier;
+    std::vector<std::vector<int>> localNext;
+    SplitMix64 rng;
+    
+    bool isVisited(std::uint32_t v) const {
+        return visited[v >> 6].load(std::memory_order_relaxed) >> (v & 63) & 1;
+    }
+    
+    // Захват вершины: true, если вершину отметил этот поток
+    bool claim(std::uint32_t v) {
+        std::uint64_t bit = 1ULL << (v & 63);
+        return !(visited[v >> 6].fetch_or(bit, std::memory_order_relaxed) & bit);
+    }
+    
+    // Шаг сверху вниз; возвращает сумму степеней нового фронта
+    std::int64_t topDown(int level, std::vector<int>& dist) {
+        if (threads == 1 || frontier.size() <= TOP_DOWN_CHUNK) {
+            // Один поток: отметки без атомарных операций чтения-записи
+            std::vector<int>& out = localNext[0];
+            std::int64_t edges = 0;
+            for (int v : frontier) {
+                for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                    std::uint64_t word = visited[*p >> 6].load(std::memory_order_relaxed);
+                    std::uint64_t bit = 1ULL << (*p & 63);
+                    if (word & bit) continue;
+                    visited[*p >> 6].store(word | bit, std::memory_order_relaxed);
+                    dist[*p] = level + 1;
+                    edges += g.degree(*p);
+                    out.push_back(*p);
+                }
+            }
+            frontier.swap(out);
+            out.clear();
+            return edges;
+        }
+        
+        parallelFor(frontier.size(), threads, TOP_DOWN_CHUNK, [&](int begin, int end, int thread) {
+            auto& out = localNext[thread];
+            for (int k = begin; k < end; ++k) {
+                int v = frontier[k];
+                for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                    if (!isVisited(*p) && claim(*p)) {
+                        dist[*p] = level + 1;
+                        out.push_back(*p);
+                    }
+                }
+            }
+        });
+        
+        frontier.clear();
+        std::int64_t edges = 0;
+        for (auto& out : localNext) {
+            for (int v : out) edges += g.degree(v);
+            frontier.insert(frontier.end(), out.begin(), out.end());
+            out.clear();
+        }
+        return edges;
+    }
+    
+    // Шаг снизу вверх по битовой карте фронта; возвращает размер нового
+    // фронта, в edges - сумму его степеней, в scanned - число просмотренных ребер
+    int bottomUp(int level, std::vector<int>& dist, std::int64_t& edges, std::int64_t& scanned) {
+        const int n = g.numVertices();
+        const int words = (n + 63) / 64;
+        std::vector<int> found(threads, 0);
+        std::vector<std::int64_t> degrees(threads, 0), checks(threads, 0);
+        
+        // Каждое слово битовых карт принадлежит одному потоку
+        parallelFor(words, threads, 16, [&](int begin, int end, int thread) {
+            for (int w = begin; w < end; ++w) {
+                std::uint64_t next = 0;
+                std::uint64_t todo = ~visited[w].load(std::memory_order_relaxed);
+                if (w == words - 1 && n % 64) todo &= (1ULL << (n % 64)) - 1;
+                while (todo) {
+                    int bit = __builtin_ctzll(todo);
+                    todo &= todo - 1;
+                    int v = w * 64 + bit;
+                    for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                        checks[thread]++;
+                        if (frontierBits[*p >> 6] >> (*p & 63) & 1) {
+                            dist[v] = level + 1;
+                            next |= 1ULL << bit;
+                            found[thread]++;
+                            degrees[thread] += g.degree(v);
+                            break;
+                        }
+                    }
+                }
+                nextBits[w] = next;
+                if (next) visited[w].fetch_or(next, std::memory_order_relaxed);
+            }
+        });
+        
+        frontierBits.swap(nextBits);
+        int size = 0;
+        edges = scanned = 0;
+        for (int t = 0; t < threads; ++t) {
+            size += found[t];
+            edges += degrees[t];
+            scanned += checks[t];
+        }
+        return size;
+    }
+
+    // Оценка числа ребер, которые просмотрит шаг снизу вверх: по выборке
+    // непосещенных вершин, каждая просматривает соседей до первого во фронте
+    double estimateBottomUpCost(std::int64_t unvisited) {
+        const int n = g.numVertices();
+        int samples = 0;
+        std::int64_t scanned = 0;
+        for (int attempt = 0; attempt < 8 * SAMPLES && samples < SAMPLES; ++attempt) {
+            std::uint32_t v = rng() % n;
+            if (isVisited(v)) continue;
+            ++samples;
+            for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                ++scanned;
+                if (frontierBits[*p >> 6] >> (*p & 63) & 1) break;
+            }
+        }
+        return samples ? (double)scanned / samples * unvisited : 0;
+    }
+
+public:
+    BFSEngine(const CSRGraph& graph, int threads = 0)
+        : g(graph), threads(threads > 0 ? threads : defaultThreadCount()),
+          visited((graph.numVertices() + 63) / 64),
+          frontierBits((graph.numVertices() + 63) / 64),
+          nextBits((graph.numVertices() + 63) / 64),
+          localNext(this->threads), rng(graph.neighbors.size()) {}
+    
+    // Расстояния в ребрах от source (-1 - вершина недостижима);
+    // возвращает эксцентриситет source
+    int run(int source, std::vector<int>& dist) {
+        const int n = g.numVertices();
+        dist.assign(n, -1);
+        for (auto& word : visited) word.store(0, std::memory_order_relaxed);
+        
+        claim(source);
+        dist[source] = 0;
+        frontier.assign(1, source);
+        std::int64_t frontierEdges = g.degree(source);
+        std::int64_t unexploredEdges = (std::int64_t)g.neighbors.size() - frontierEdges;
+        std::int64_t unvisited = n - 1;
+        
+        int level = 0;
+        bool bottomUpMode = false;
+        int frontierSize = 1;
+        while (frontierSize > 0) {
+            if (!bottomUpMode && frontierEdges > unexploredEdges / ALPHA) {
+                // Переход к битовой карте фронта, если по выборке непосещенных
+                // вершин шаг снизу вверх дешевле: в графах с большим диаметром
+                // (геометрических) они редко соседствуют с фронтом
+                std::fill(frontierBits.begin(), frontierBits.end(), 0);
+                for (int v : frontier) frontierBits[v >> 6] |= 1ULL << (v & 63);
+                bottomUpMode = estimateBottomUpCost(unvisited) < frontierEdges;
+            } else if (bottomUpMode && frontierSize < n / BETA) {
+                // Обратно к списку вершин фронта
+                frontier.clear();
+                for (size_t w = 0; w < frontierBits.size(); ++w) {
+                    for (std::uint64_t bits = frontierBits[w]; bits; bits &= bits - 1) {
+                        frontier.push_back(w * 64 + __builtin_ctzll(bits));
+                    }
+                }
+                bottomUpMode = false;
+            }
+            
+            if (bottomUpMode) {
+                std::int64_t topDownCost = frontierEdges, scanned;
+                frontierSize = bottomUp(level, dist, frontierEdges, scanned);
+                // Шаг оказался дороже шага сверху вниз - следующий сверху вниз
+                if (scanned > topDownCost) {
+                    frontier.clear();
+                    for (size_t w = 0; w < frontierBits.size(); ++w) {
+                        for (std::uint64_t bits = frontierBits[w]; bits; bits &= bits - 1) {
+                            frontier.push_back(w * 64 + __builtin_ctzll(bits));
+                        }
+                    }
+                    bottomUpMode = false;
+                }
+            } else {
+                frontierEdges = topDown(level, dist);
+                frontierSize = frontier.size();
+            }
+            unexploredEdges -= frontierEdges;
+            unvisited -= frontierSize;
+            if (frontierSize > 0) ++level;
+        }
+        return level;
+    }
+};
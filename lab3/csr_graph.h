@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "parallel.h"
+
+// Неориентированный граф в сжатом виде (CSR): соседи вершины v хранятся
+// подряд в neighbors[offset[v] .. offset[v+1]), каждое ребро - дважды.
+// Атрибуты ребер хранятся в отдельных массивах параллельно neighbors;
+// пустой массив означает, что атрибут не хранится.
+struct CSRGraph {
+    std::vector<std::int64_t> offset;
+    std::vector<std::uint32_t> neighbors;
+    std::vector<float> weights;
+    std::vector<float> probabilities;
+    
+    int numVertices() const { return offset.empty() ? 0 : (int)offset.size() - 1; }
+    std::int64_t numEdges() const { return (std::int64_t)neighbors.size() / 2; }
+    int degree(int v) const { return (int)(offset[v + 1] - offset[v]); }
+    
+    const std::uint32_t* begin(int v) const { return neighbors.data() + offset[v]; }
+    const std::uint32_t* end(int v) const { return neighbors.data() + offset[v + 1]; }
+    
+    // Сортировка соседей каждой вершины по номеру (атрибуты переставляются вместе)
+    void sortNeighbors(int threads) {
+        parallelFor(numVertices(), threads, 1024, [&](int begin, int end, int) {
+            std::vector<int> order;
+            std::vector<std::uint32_t> ids;
+            std::vector<float> values;
+            for (int v = begin; v < end; ++v) {
+                std::uint32_t* first = neighbors.data() + offset[v];
+                int count = degree(v);
+                if (std::is_sorted(first, first + count)) continue;
+                
+                order.resize(count);
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&](int x, int y) { return first[x] < first[y]; });
+                
+                ids.assign(first, first + count);
+                for (int k = 0; k < count; ++k) first[k] = ids[order[k]];
+                for (auto* attribute : {&weights, &probabilities}) {
+                    if (attribute->empty()) continue;
+                    float* values0 = attribute->data() + offset[v];
+                    values.assign(values0, values0 + count);
+                    for (int k = 0; k < count; ++k) values0[k] = values[order[k]];
+                }
+            }
+        });
+    }
+    
+    // Удаление ребер на месте: keep(v, u, k) решает, оставить ли k-й элемент
+    // массива соседей (ребро v-u). Решение должно быть симметричным и не
+    // должно использовать offset - смещения перезаписываются по ходу.
+    template <typename Keep>
+    void compact(Keep keep) {
+        const int n = numVertices();
+        std::int64_t write = 0;
+        for (int v = 0; v < n; ++v) {
+            std::int64_t begin = offset[v], end = offset[v + 1];
+            offset[v] = write;
+            for (std::int64_t k = begin; k < end; ++k) {
+                if (!keep(v, neighbors[k], k)) continue;
+                neighbors[write] = neighbors[k];
+                if (!weights.empty()) weights[write] = weights[k];
+                if (!probabilities.empty()) probabilities[write] = probabilities[k];
+                ++write;
+            }
+        }
+        offset[n] = write;
+        neighbors.resize(write);
+        neighbors.shrink_to_fit();
+        for (auto* attribute : {&weights, &probabilities}) {
+            if (attribute->empty()) continue;
+            attribute->resize(write);
+            attribute->shrink_to_fit();
+        }
+    }
+    
+    // Пустой граф (для объектов, которым граф не понадобится)
+    static const CSRGraph& empty() {
+        static const CSRGraph graph;
+        return graph;
+    }
+};
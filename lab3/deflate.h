@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Сжатие deflate без внешних библиотек (для PNG и gzip): один блок с
+// фиксированными кодами Хаффмана, LZ77 с хеш-таблицей по трем байтам и
+// дополнительными кандидатами "три байта назад" (предыдущий пиксель RGB)
+// и "строкой выше" для изображений.
+class Deflate {
+private:
+    class BitWriter {
+    public:
+        std::vector<std::uint8_t> bytes;
+        std::uint32_t buffer = 0;
+        int count = 0;
+        
+        // Запись младших bits битов value начиная с младшего
+        void put(std::uint32_t value, int bits) {
+            buffer |= value << count;
+            count += bits;
+            while (count >= 8) {
+                bytes.push_back(buffer & 0xFF);
+                buffer >>= 8;
+                count -= 8;
+            }
+        }
+        
+        // Код Хаффмана пишется начиная со старшего бита
+        void putCode(std::uint32_t code, int bits) {
+            std::uint32_t reversed = 0;
+            for (int i = 0; i < bits; ++i) reversed |= (code >> i & 1) << (bits - 1 - i);
+            put(reversed, bits);
+        }
+        
+        void finish() {
+            if (count > 0) bytes.push_back(buffer & 0xFF);
+            buffer = 0;
+            count = 0;
+        }
+    };
+    
+    static void literal(BitWriter& out, int symbol) {
+        if (symbol < 144) out.putCode(0x30 + symbol, 8);
+        else if (symbol < 256) out.putCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280) out.putCode(symbol - 256, 7);
+        else out.putCode(0xC0 + symbol - 280, 8);
+    }
+    
+    static void match(BitWriter& out, int length, int distance) {
+        static const int lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                           35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const int distBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                         257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                         8193, 12289, 16385, 24577};
+        static const int distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                          7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        int l = int(std::upper_bound(lengthBase, lengthBase + 29, length) - lengthBase) - 1;
+        literal(out, 257 + l);
+        out.put(length - lengthBase[l], lengthExtra[l]);
+        int d = int(std::upper_bound(distBase, distBase + 30, distance) - distBase) - 1;
+        out.putCode(d, 5);
+        out.put(distance - distBase[d], distExtra[d]);
+    }
+    
+public:
+    // Сжатие блоком deflate без заголовков. stride > 0 - длина строки
+    // изображения: позиция строкой выше проверяется как кандидат совпадения
+    static std::vector<std::uint8_t> compress(const std::uint8_t* data, size_t n, int stride = 0) {
+        const int WINDOW = 32768, MIN_MATCH = 3, MAX_MATCH = 258, HASH_BITS = 15;
+        BitWriter out;
+        out.put(1, 1);               // последний блок
+        out.put(1, 2);               // фиксированные коды
+        
+        std::vector<int> head(1 << HASH_BITS, -1);
+        auto hash = [&](size_t i) {
+            std::uint32_t v = data[i] | data[i + 1] << 8 | data[i + 2] << 16;
+            return (v * 2654435761u) >> (32 - HASH_BITS);
+        };
+        auto matchLength = [&](size_t i, size_t j) {
+            size_t limit = std::min<size_t>(MAX_MATCH, n - i);
+            size_t k = 0;
+            while (k < limit && data[i + k] == data[j + k]) ++k;
+            return (int)k;
+        };
+        
+        size_t i = 0;
+        while (i < n) {
+            int bestLength = 0, bestDistance = 0;
+            if (i + MIN_MATCH <= n) {
+                std::uint32_t h = hash(i);
+                int candidates[3] = {head[h], (int)i - 3, stride > 0 ? (int)i - stride : -1};
+                head[h] = (int)i;
+                for (int c : candidates) {
+                    if (c < 0 || (int)i - c > WINDOW || c >= (int)i) continue;
+                    int length = matchLength(i, c);
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = (int)i - c;
+                    }
+                }
+            }
+            if (bestLength >= MIN_MATCH) {
+                match(out, bestLength, bestDistance);
+                // Позиции внутри совпадения добавляются в хеш-таблицу выборочно
+                for (size_t k = i + 1; k < i + bestLength && k + MIN_MATCH <= n; k += 16) {
+                    head[hash(k)] = (int)k;
+                }
+                i += bestLength;
+            } else {
+                literal(out, data[i]);
+                ++i;
+            }
+        }
+        literal(out, 256);
+        out.finish();
+        return out.bytes;
+    }
+    
+    // Контрольная сумма zlib
+    static std::uint32_t adler32(const std::uint8_t* data, size_t size) {
+        std::uint32_t a = 1, b = 0;
+        for (size_t i = 0; i < size; ++i) {
+            a = (a + data[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        return b << 16 | a;
+    }
+    
+    // CRC-32 (PNG, gzip); crc - значение для предыдущей части данных
+    static std::uint32_t crc32(const std::uint8_t* data, size_t size, std::uint32_t crc = 0) {
+        crc = ~crc;
+        static const std::array<std::uint32_t, 256> table = [] {
+            std::array<std::uint32_t, 256> t{};
+            for (std::uint32_t n = 0; n < 256; ++n) {
+                std::uint32_t c = n;
+                for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+    
+};
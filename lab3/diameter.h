@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "bfs.h"
+#include "csr_graph.h"
+#include "parallel.h"
+
+// Точный диаметр (в ребрах) без обхода из каждой вершины.
+//
+// Для каждой компоненты связности используется iFUB: из центральной вершины
+// u (середина пути, найденного двойным проходом) строятся уровни BFS, затем
+// эксцентриситеты считаются только для вершин дальних уровней, пока нижняя
+// оценка не превысит 2*(i-1) - верхнюю оценку для оставшихся вершин.
+// Вершины одного уровня обрабатываются параллельно; по 64 вершины
+// одновременно - битово-параллельным BFS (одна маска из 64 бит на вершину).
+// Для несвязного графа результат - наибольший диаметр компонент.
+class DiameterSolver {
+private:
+    const CSRGraph& g;
+    int threads;
+    
+    // BFS из source по вершинам компоненты; dist должен быть заполнен -1
+    // для вершин компоненты. Возвращает последнюю достигнутую вершину,
+    // в ecc - ее расстояние.
+    int bfs(int source, std::vector<int>& dist, std::vector<int>& queue, int& ecc) const {
+        queue.clear();
+        queue.push_back(source);
+        dist[source] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int v = queue[head];
+            for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                if (dist[*p] < 0) {
+                    dist[*p] = dist[v] + 1;
+                    queue.push_back(*p);
+                }
+            }
+        }
+        int last = queue.back();
+        ecc = dist[last];
+        return last;
+    }
+    
+    // Эксцентриситет одной вершины (буферы потока, dist восстанавливается)
+    int eccentricity(int source, std::vector<int>& dist, std::vector<int>& queue) const {
+        int ecc;
+        bfs(source, dist, queue, ecc);
+        for (int v : queue) dist[v] = -1;
+        return ecc;
+    }
+    
+    // Наибольший эксцентриситет группы до 64 вершин за один битово-параллельный
+    // обход: seen[v] - источники, уже достигшие v, frontier[v] - достигшие v
+    // на текущем уровне. Просматриваются только вершины фронта, поэтому
+    // обход не дороже 64 обычных BFS, а при пересечении фронтов намного дешевле.
+    // Массивы должны быть нулевыми и остаются нулевыми после вызова.
+    int batchEccentricity(const int* sources, int count,
+                          std::vector<std::uint64_t>& seen,
+                          std::vector<std::uint64_t>& frontier,
+                          std::vector<std::uint64_t>& next,
+                          std::vector<int>& active, std::vector<int>& touched) const {
+        active.clear();
+        touched.clear();
+        for (int k = 0; k < count; ++k) {
+            if (seen[sources[k]] == 0) {
+                active.push_back(sources[k]);
+                touched.push_back(sources[k]);
+            }
+            seen[sources[k]] |= 1ULL << k;
+            frontier[sources[k]] |= 1ULL << k;
+        }
+        
+        int level = 0;
+        std::vector<int> upcoming;
+        while (!active.empty()) {
+            upcoming.clear();
+            for (int v : active) {
+                for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                    std::uint64_t fresh = frontier[v] & ~seen[*p];
+                    if (fresh == 0) continue;
+                    if (next[*p] == 0) upcoming.push_back(*p);
+                    if (seen[*p] == 0) touched.push_back(*p);
+                    next[*p] |= fresh;
+                    seen[*p] |= fresh;
+                }
+            }
+            for (int v : active) frontier[v] = 0;
+            for (int v : upcoming) {
+                frontier[v] = next[v];
+                next[v] = 0;
+            }
+            active.swap(upcoming);
+            if (!active.empty()) ++level;
+        }
+        for (int v : touched) seen[v] = 0;
+        return level;
+    }
+    
+    // Наибольший эксцентриситет множества вершин (параллельно)
+    int maxEccentricity(const std::vector<int>& level) const {
+        std::atomic<int> best(0);
+        auto update = [&](int value) {
+            int current = best.load();
+            while (value > current && !best.compare_exchange_weak(current, value)) {}
+        };
+        
+        if (level.size() >= 64) {
+            int batches = (level.size() + 63) / 64;
+            parallelFor(batches, threads, 1, [&](int begin, int end, int) {
+                std::vector<std::uint64_t> seen(g.numVertices()), frontier(g.numVertices()),
+                                           next(g.numVertices());
+                std::vector<int> active, touched;
+                for (int b = begin; b < end; ++b) {
+                    int count = std::min<int>(64, level.size() - b * 64);
+                    update(batchEccentricity(level.data() + b * 64, count,
+                                             seen, frontier, next, active, touched));
+                }
+            });
+        } else {
+            parallelFor(level.size(), threads, 1, [&](int begin, int end, int) {
+                std::vector<int> dist(g.numVertices(), -1), queue;
+                for (int k = begin; k < end; ++k) update(eccentricity(level[k], dist, queue));
+            });
+        }
+        return best.load();
+    }
+    
+    // Диаметр компоненты, содержащей вершины vertices
+    int componentDiameter(const std::vector<int>& vertices) const {
+        std::vector<int> dist(g.numVertices(), -1), queue;
+        
+        // Обходы по большой компоненте выполняются параллельным BFS (он
+        // обнуляет массивы на весь граф, поэтому для мелких компонент - обычный)
+        const bool large = vertices.size() >= 4096 && vertices.size() * 64 >= (size_t)g.numVertices();
+        BFSEngine engine(large ? g : CSRGraph::empty(), threads);
+        auto sweep = [&](int source, int& ecc) {
+            for (int v : vertices) dist[v] = -1;
+            if (!large) return bfs(source, dist, queue, ecc);
+            ecc = engine.run(source, dist);
+            int farthest = source;
+            for (int v : vertices) {
+                if (dist[v] > dist[farthest]) farthest = v;
+            }
+            return farthest;
+        };
+        
+        // Двойной проход от вершины наибольшей степени
+        int start = *std::max_element(vertices.begin(), vertices.end(),
+                                      [&](int x, int y) { return g.degree(x) < g.degree(y); });
+        int ecc;
+        int a = sweep(start, ecc);
+        int b = sweep(a, ecc);
+        int lower = ecc;
+        
+        // Середина пути a-b - корень уровней iFUB
+        int u = b;
+        while (dist[u] > ecc - ecc / 2) {
+            for (const std::uint32_t* p = g.begin(u); p != g.end(u); ++p) {
+                if (dist[*p] == dist[u] - 1) {
+                    u = *p;
+                    break;
+                }
+            }
+        }
+        
+        sweep(u, ecc);
+        lower = std::max(lower, ecc);
+        std::vector<std::vector<int>> levels(ecc + 1);
+        for (int v : vertices) levels[dist[v]].push_back(v);
+        
+        // Вершины уровня i удалены от любой вершины уровней < i не более
+        // чем на 2*(i-1); уровни обрабатываются от дальнего к ближнему
+        for (int i = ecc; i > 0 && lower < 2 * i; --i) {
+            lower = std::max(lower, maxEccentricity(levels[i]));
+            if (lower > 2 * (i - 1)) break;
+        }
+        return lower;
+    }
+    
+public:
+    DiameterSolver(const CSRGraph& graph, int threads = 0)
+        : g(graph), threads(threads > 0 ? threads : defaultThreadCount()) {}
+    
+    int solve() {
+        const int n = g.numVertices();
+        int diameter = 0;
+        std::vector<int> component(n, -1);
+        std::vector<int> vertices;
+        for (int root = 0; root < n; ++root) {
+            if (component[root] >= 0) continue;
+            
+            // Вершины компоненты root
+            vertices.assign(1, root);
+            component[root] = root;
+            for (size_t head = 0; head < vertices.size(); ++head) {
+                int v = vertices[head];
+                for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                    if (component[*p] < 0) {
+                        component[*p] = root;
+                        vertices.push_back(*p);
+                    }
+                }
+            }
+            // Диаметр компоненты не больше числа ее вершин - 1
+            if ((int)vertices.size() - 1 > diameter) {
+                diameter = std::max(diameter, componentDiameter(vertices));
+            }
+        }
+        return diameter;
+    }
+};
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bfs.h"
+#include "csr_graph.h"
+#include "parallel.h"
+
+// Границы диаметра (в ребрах)
+struct DiameterBounds {
+    int lower = 0;
+    int upper = 0;
+    
+    bool exact() const { return lower == upper; }
+};
+
+// Функция окрестностей: within[t] - число упорядоченных пар (u, v), включая
+// u = v, с расстоянием не больше t; последний элемент - все связанные пары.
+// error - заявленная точность: для выборки - отклонение доли пар
+// (с доверием confidence), для HyperANF - относительная ошибка счетчика.
+struct DistanceDistribution {
+    std::vector<double> within;
+    double error = 0;
+    
+    // Наименьшее t (с линейной интерполяцией), при котором расстояние не
+    // больше t имеют quantile всех связанных пар
+    double effectiveDiameter(double quantile = 0.9) const {
+        if (within.empty()) return 0;
+        double target = quantile * within.back();
+        for (size_t t = 0; t < within.size(); ++t) {
+            if (within[t] < target) continue;
+            if (t == 0) return 0;
+            double step = within[t] - within[t - 1];
+            return t - 1 + (step > 0 ? (target - within[t - 1]) / step : 1);
+        }
+        return within.size() - 1;
+    }
+    
+    // Среднее расстояние между различными связанными вершинами
+    double averageDistance() const {
+        if (within.size() < 2) return 0;
+        double sum = 0;
+        for (size_t t = 1; t < within.size(); ++t) sum += t * (within[t] - within[t - 1]);
+        double pairs = within.back() - within[0];
+        return pairs > 0 ? sum / pairs : 0;
+    }
+};
+
+// Приближенные диаметр и распределение расстояний для графов, где даже
+// точный диаметр (DiameterSolver) слишком долог:
+//   - sweepBounds: по три BFS на компоненту (двойной проход и обход из
+//     середины найденного пути) дают нижнюю и верхнюю границы диаметра;
+//   - sample: BFS из k случайных вершин; k выбирается по неравенству
+//     Хёфдинга так, чтобы доля пар на расстоянии не больше t отклонялась
+//     не более чем на error с доверием confidence при каждом t. Каждый обход
+//     уточняет границы: ecc(s) <= D <= 2 ecc(s) в компоненте s;
+//   - hyperANF: счетчики HyperLogLog всех вершин объединяются с соседями
+//     раунд за раундом (Boldi, Rosa, Vigna); раундов столько, каков диаметр,
+//     поэтому метод хорош для графов малого мира, а для геометрических с
+//     большим диаметром выгоднее выборка.
+// Память: выборка - по массиву расстояний на поток, HyperANF - два байта
+// на регистр счетчика, число регистров подбирается под memoryLimit.
+class DistanceSketch {
+private:
+    const CSRGraph& g;
+    int threads;
+    std::vector<int> component;       // номер компоненты вершины
+    std::vector<int> componentSize;
+    std::vector<int> lower, upper;    // границы диаметров компонент
+    
+    // BFS из source; dist заполнен -1 и восстанавливается вызывающим по queue.
+    // В levels[t] добавляется число вершин на расстоянии t; возвращает
+    // последнюю достигнутую вершину
+    int bfs(int source, std::vector<int>& dist, std::vector<int>& queue,
+            std::vector<double>* levels = nullptr) const {
+        queue.assign(1, source);
+        dist[source] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int v = queue[head];
+            if (levels) {
+                if ((int)levels->size() <= dist[v]) levels->resize(dist[v] + 1, 0);
+                (*levels)[dist[v]] += 1;
+            }
+            for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                if (dist[*p] < 0) {
+                    dist[*p] = dist[v] + 1;
+                    queue.push_back(*p);
+                }
+            }
+        }
+        return queue.back();
+    }
+    
+    DiameterBounds total() const {
+        DiameterBounds bounds;
+        for (size_t c = 0; c < lower.size(); ++c) {
+            bounds.lower = std::max(bounds.lower, lower[c]);
+            bounds.upper = std::max(bounds.upper, upper[c]);
+        }
+        return bounds;
+    }
+    
+    // Оценка мощности счетчика HyperLogLog из m регистров (с поправкой
+    // линейного счета для малых множеств)
+    static double estimate(const std::uint8_t* registers, int m) {
+        double sum = 0;
+        int zeros = 0;
+        for (int i = 0; i < m; ++i) {
+            sum += std::ldexp(1.0, -registers[i]);
+            zeros += registers[i] == 0;
+        }
+        double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros > 0) return m * std::log((double)m / zeros);
+        return raw;
+    }
+    
+public:
+    // Компоненты связности находятся сразу; их границы - число вершин - 1
+    DistanceSketch(const CSRGraph& graph, int threads = 0)
+        : g(graph), threads(threads > 0 ? threads : defaultThreadCount()),
+          component(graph.numVertices(), -1) {
+        std::vector<int> queue;
+        for (int root = 0; root < g.numVertices(); ++root) {
+            if (component[root] >= 0) continue;
+            int c = componentSize.size();
+            queue.assign(1, root);
+            component[root] = c;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                for (const std::uint32_t* p = g.begin(queue[head]); p != g.end(queue[head]); ++p) {
+                    if (component[*p] < 0) {
+                        component[*p] = c;
+                        queue.push_back(*p);
+                    }
+                }
+            }
+            componentSize.push_back(queue.size());
+            lower.push_back(queue.size() > 1);
+            upper.push_back(queue.size() - 1);
+        }
+    }
+    
+    // Границы двойным проходом: от вершины наибольшей степени к дальней a,
+    // от a к дальней b (ecc(a) - нижняя граница), затем из середины пути a-b;
+    // верхняя граница - удвоенный наименьший из найденных эксцентриситетов.
+    // Большие компоненты обходятся параллельным BFSEngine.
+    DiameterBounds sweepBounds() {
+        const int n = g.numVertices();
+        std::vector<int> start(componentSize.size(), -1);
+        for (int v = 0; v < n; ++v) {
+            int& s = start[component[v]];
+            if (s < 0 || g.degree(v) > g.degree(s)) s = v;
+        }
+        
+        std::vector<int> dist(n, -1), queue;
+        std::unique_ptr<BFSEngine> engine;
+        for (size_t c = 0; c < componentSize.size(); ++c) {
+            if (componentSize[c] < 3) continue;   // диаметр 0 или 1 уже известен
+            const bool large = componentSize[c] >= 4096 && (std::int64_t)componentSize[c] * 64 >= n;
+            if (large && !engine) engine = std::make_unique<BFSEngine>(g, threads);
+            
+            // Обход из source: эксцентриситет и самая дальняя вершина
+            auto sweep = [&](int source, int& ecc) {
+                if (!large) {
+                    for (int v : queue) dist[v] = -1;
+                    int last = bfs(source, dist, queue);
+                    ecc = dist[last];
+                    return last;
+                }
+                ecc = engine->run(source, dist);
+                queue.clear();
+                int farthest = source;
+                for (int v = 0; v < n; ++v) {
+                    if (dist[v] > dist[farthest]) farthest = v;
+                }
+                return farthest;
+            };
+            
+            int first, second, third;
+            int a = sweep(start[c], first);
+            int b = sweep(a, second);
+            int middle = b;
+            while (dist[middle] > second - second / 2) {
+                for (const std::uint32_t* p = g.begin(middle); p != g.end(middle); ++p) {
+                    if (dist[*p] == dist[middle] - 1) {
+                        middle = *p;
+                        break;
+                    }
+                }
+            }
+            sweep(middle, third);
+            lower[c] = std::max(lower[c], std::max(second, third));
+            upper[c] = std::min(upper[c], 2 * std::min(first, std::min(second, third)));
+            
+            if (large) dist.assign(n, -1);
+        }
+        for (int v : queue) dist[v] = -1;
+        return total();
+    }
+    
+    // Распределение расстояний по BFS из случайных вершин (с возвращением);
+    // bounds - уточненные границы диаметра
+    DistanceDistribution sample(double error, double confidence, std::uint64_t seed,
+                                DiameterBounds& bounds) {
+        const int n = g.numVertices();
+        DistanceDistribution result;
+        result.error = error;
+        if (n == 0) return result;
+        int k = (int)std::ceil(std::log(2 / (1 - confidence)) / (2 * error * error));
+        
+        SplitMix64 rng(seed, 0);
+        std::vector<int> sources(k), eccentricity(k);
+        for (int& s : sources) s = rng() % n;
+        
+        // Обходы параллельно по источникам, у каждого потока свои буферы
+        // и гистограмма расстояний
+        std::vector<std::vector<double>> levels(threads);
+        parallelFor(k, threads, 1, [&](int begin, int end, int thread) {
+            std::vector<int> dist(n, -1), queue;
+            for (int i = begin; i < end; ++i) {
+                int last = bfs(sources[i], dist, queue, &levels[thread]);
+                eccentricity[i] = dist[last];
+                for (int v : queue) dist[v] = -1;
+            }
+        });
+        
+        for (int i = 0; i < k; ++i) {
+            int c = component[sources[i]];
+            lower[c] = std::max(lower[c], eccentricity[i]);
+            upper[c] = std::min(upper[c], 2 * eccentricity[i]);
+        }
+        bounds = total();
+        
+        for (const auto& part : levels) {
+            if (part.size() > result.within.size()) result.within.resize(part.size(), 0);
+            for (size_t t = 0; t < part.size(); ++t) result.within[t] += part[t];
+        }
+        double scale = (double)n / k;
+        for (size_t t = 0; t < result.within.size(); ++t) {
+            result.within[t] = result.within[t] * scale + (t ? result.within[t - 1] : 0);
+        }
+        return result;
+    }
+    
+    // Функция окрестностей HyperANF. Регистров на счетчик - степень двойки,
+    // дающая относительную ошибку 1.04/sqrt(m) не больше error, но не больше,
+    // чем помещается в memoryLimit байт. В каждом раунде пересчитываются
+    // только вершины, у которых изменился счетчик соседа. Раунд, в котором
+    // изменился хоть один счетчик, доказывает, что диаметр не меньше его номера.
+    DistanceDistribution hyperANF(double error, size_t memoryLimit, std::uint64_t seed,
+                                  DiameterBounds& bounds) {
+        const int n = g.numVertices();
+        int bits = 4;
+        while (bits < 12 && 1.04 / std::sqrt((double)(1 << bits)) > error) ++bits;
+        while (bits > 4 && 2 * (size_t)n << bits > memoryLimit) --bits;
+        const int m = 1 << bits;
+        
+        DistanceDistribution result;
+        result.error = 1.04 / std::sqrt((double)m);
+        if (n == 0) return result;
+        
+        std::vector<std::uint8_t> current((size_t)n * m, 0), next((size_t)n * m, 0);
+        std::vector<float> size(n);
+        std::vector<char> changed(n, 1), changedNext(n, 0);
+        for (int v = 0; v < n; ++v) {
+            // Старшие bits бит хеша - номер регистра, в регистре - номер
+            // первой единицы в остальных битах
+            std::uint64_t hash = SplitMix64(seed, v)();
+            std::uint64_t rest = hash << bits | (1ULL << (bits - 1));
+            current[(size_t)v * m + (hash >> (64 - bits))] = __builtin_clzll(rest) + 1;
+            size[v] = estimate(&current[(size_t)v * m], m);
+        }
+        auto sum = [&]() {
+            double total = 0;
+            for (float s : size) total += s;
+            return total;
+        };
+        result.within.push_back(sum());
+        
+        int rounds = 0;
+        for (;;) {
+            std::vector<int> count(threads, 0);
+            parallelFor(n, threads, 1024, [&](int begin, int end, int thread) {
+                for (int v = begin; v < end; ++v) {
+                    std::uint8_t* out = &next[(size_t)v * m];
+                    const std::uint8_t* own = &current[(size_t)v * m];
+                    bool dirty = false;
+                    for (const std::uint32_t* p = g.begin(v); p != g.end(v) && !dirty; ++p) {
+                        dirty = changed[*p];
+                    }
+                    changedNext[v] = 0;
+                    if (!dirty) {
+                        // Буфер next хранит счетчик позапрошлого раунда
+                        if (changed[v]) std::copy(own, own + m, out);
+                        continue;
+                    }
+                    std::copy(own, own + m, out);
+                    for (const std::uint32_t* p = g.begin(v); p != g.end(v); ++p) {
+                        const std::uint8_t* other = &current[(size_t)*p * m];
+                        for (int i = 0; i < m; ++i) out[i] = std::max(out[i], other[i]);
+                    }
+                    if (!std::equal(out, out + m, own)) {
+                        changedNext[v] = 1;
+                        size[v] = estimate(out, m);
+                        ++count[thread];
+                    }
+                }
+            });
+            
+            int updated = 0;
+            for (int c : count) updated += c;
+            if (updated == 0) break;
+            ++rounds;
+            current.swap(next);
+            changed.swap(changedNext);
+            result.within.push_back(std::max(sum(), result.within.back()));
+        }
+        
+        bounds = total();
+        bounds.lower = std::max(bounds.lower, rounds);
+        return result;
+    }
+};
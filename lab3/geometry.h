@@ -0,0 +1,7 @@
+#pragma once
+
+// Точка на плоскости
+struct Point {
+    double x, y;
+    Point(double x = 0, double y = 0) : x(x), y(y) {}
+};
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "csr_graph.h"
+#include "deflate.h"
+#include "geometry.h"
+
+// Потоковая запись графа: вершины с координатами передаются в begin, затем
+// ребра по одному в любом порядке. Ребра нигде не накапливаются, поэтому
+// граф можно писать прямо из генератора. Неизвестная вероятность ребра - NaN,
+// такое поле не записывается.
+class GraphWriter {
+public:
+    virtual ~GraphWriter() = default;
+    virtual bool isOpen() const = 0;
+    virtual void begin(const std::vector<Point>& points) = 0;
+    virtual void edge(std::uint32_t v, std::uint32_t u, float weight, float probability) = 0;
+    // Завершение записи; false при ошибке ввода-вывода
+    virtual bool end() = 0;
+};
+
+// Буферизованный вывод в файл; при сжатии каждый заполненный буфер
+// записывается отдельным членом gzip (склейка членов - корректный gzip)
+class OutputStream {
+private:
+    FILE* out;
+    bool gzip;
+    bool failed = false;
+    std::vector<char> buffer;
+    size_t used = 0;
+    
+    void writeMember() {
+        const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(buffer.data());
+        std::vector<std::uint8_t> block = Deflate::compress(data, used);
+        std::uint32_t crc = Deflate::crc32(data, used);
+        std::uint32_t size = (std::uint32_t)used;
+        const std::uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+        std::uint8_t trailer[8];
+        for (int k = 0; k < 4; ++k) {
+            trailer[k] = crc >> (8 * k) & 0xFF;
+            trailer[4 + k] = size >> (8 * k) & 0xFF;
+        }
+        failed |= fwrite(header, 1, 10, out) != 10;
+        failed |= fwrite(block.data(), 1, block.size(), out) != block.size();
+        failed |= fwrite(trailer, 1, 8, out) != 8;
+    }
+
+public:
+    OutputStream(const std::string& filename, bool compress, size_t capacity = 1 << 20)
+        : out(fopen(filename.c_str(), "wb")), gzip(compress), buffer(capacity) {}
+    
+    ~OutputStream() {
+        close();
+    }
+    
+    OutputStream(const OutputStream&) = delete;
+    OutputStream& operator=(const OutputStream&) = delete;
+    
+    bool isOpen() const { return out != nullptr; }
+    
+    void flush() {
+        if (!out || used == 0) return;
+        if (gzip) writeMember();
+        else failed |= fwrite(buffer.data(), 1, used, out) != used;
+        used = 0;
+    }
+    
+    void write(const char* data, size_t size) {
+        while (size > 0) {
+            if (used == buffer.size()) flush();
+            size_t part = std::min(size, buffer.size() - used);
+            std::memcpy(buffer.data() + used, data, part);
+            used += part;
+            data += part;
+            size -= part;
+        }
+    }
+    
+    void write(const std::string& text) { write(text.data(), text.size()); }
+    
+    // Форматированная запись (строка не длиннее 256 символов)
+    template <typename... Args>
+    void print(const char* format, Args... args) {
+        char line[256];
+        int size = std::snprintf(line, sizeof(line), format, args...);
+        write(line, std::min<size_t>(size, sizeof(line) - 1));
+    }
+    
+    bool close() {
+        if (!out) return false;
+        flush();
+        failed |= fclose(out) != 0;
+        out = nullptr;
+        return !failed;
+    }
+};
+
+// Список ребер: строка "# vertices n" и строки "v u длина [вероятность]"
+// (вершины с нуля); имя с окончанием .gz - сжатие gzip
+class EdgeListWriter : public GraphWriter {
+private:
+    OutputStream out;
+
+public:
+    EdgeListWriter(const std::string& filename, bool compress) : out(filename, compress) {}
+    
+    bool isOpen() const override { return out.isOpen(); }
+    
+    void begin(const std::vector<Point>& points) override {
+        out.print("# vertices %zu\n", points.size());
+    }
+    
+    void edge(std::uint32_t v, std::uint32_t u, float weight, float probability) override {
+        if (std::isnan(probability)) out.print("%u %u %.6g\n", v, u, weight);
+        else out.print("%u %u %.6g %.6g\n", v, u, weight, probability);
+    }
+    
+    bool end() override { return out.close(); }
+};
+
+// GraphML: координаты вершин и атрибуты ребер как данные с ключами
+class GraphMLWriter : public GraphWriter {
+private:
+    OutputStream out;
+
+public:
+    explicit GraphMLWriter(const std::string& filename) : out(filename, false) {}
+    
+    bool isOpen() const override { return out.isOpen(); }
+    
+    void begin(const std::vector<Point>& points) override {
+        out.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+                  "<key id=\"x\" for=\"node\" attr.name=\"x\" attr.type=\"double\"/>\n"
+                  "<key id=\"y\" for=\"node\" attr.name=\"y\" attr.type=\"double\"/>\n"
+                  "<key id=\"w\" for=\"edge\" attr.name=\"weight\" attr.type=\"double\"/>\n"
+                  "<key id=\"p\" for=\"edge\" attr.name=\"probability\" attr.type=\"double\"/>\n"
+                  "<graph id=\"G\" edgedefault=\"undirected\">\n");
+        for (size_t v = 0; v < points.size(); ++v) {
+            out.print("<node id=\"n%zu\"><data key=\"x\">%.17g</data><data key=\"y\">%.17g</data></node>\n",
+                      v, points[v].x, points[v].y);
+        }
+    }
+    
+    void edge(std::uint32_t v, std::uint32_t u, float weight, float probability) override {
+        out.print("<edge source=\"n%u\" target=\"n%u\"><data key=\"w\">%.6g</data>", v, u, weight);
+        if (!std::isnan(probability)) out.print("<data key=\"p\">%.6g</data>", probability);
+        out.write("</edge>\n");
+    }
+    
+    bool end() override {
+        out.write("</graph>\n</graphml>\n");
+        return out.close();
+    }
+};
+
+// DOT (Graphviz): вершины закреплены в своих координатах (pos="x,y!")
+class DOTWriter : public GraphWriter {
+private:
+    OutputStream out;
+
+public:
+    explicit DOTWriter(const std::string& filename) : out(filename, false) {}
+    
+    bool isOpen() const override { return out.isOpen(); }
+    
+    void begin(const std::vector<Point>& points) override {
+        out.write("graph G {\n  node [shape=point];\n");
+        for (size_t v = 0; v < points.size(); ++v) {
+            out.print("  %zu [pos=\"%.6g,%.6g!\"];\n", v, points[v].x, points[v].y);
+        }
+    }
+    
+    void edge(std::uint32_t v, std::uint32_t u, float weight, float probability) override {
+        if (std::isnan(probability)) out.print("  %u -- %u [weight=%.6g];\n", v, u, weight);
+        else out.print("  %u -- %u [weight=%.6g, probability=%.6g];\n", v, u, weight, probability);
+    }
+    
+    bool end() override {
+        out.write("}\n");
+        return out.close();
+    }
+};
+
+inline bool hasSuffix(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Потоковый формат по расширению: .graphml, .dot/.gv, иначе список ребер
+// (.gz - сжатый); nullptr, если файл не открылся
+inline std::unique_ptr<GraphWriter> makeGraphWriter(const std::string& filename) {
+    std::unique_ptr<GraphWriter> writer;
+    if (hasSuffix(filename, ".graphml")) writer = std::make_unique<GraphMLWriter>(filename);
+    else if (hasSuffix(filename, ".dot") || hasSuffix(filename, ".gv")) writer = std::make_unique<DOTWriter>(filename);
+    else writer = std::make_unique<EdgeListWriter>(filename, hasSuffix(filename, ".gz"));
+    if (!writer->isOpen()) writer.reset();
+    return writer;
+}
+
+// Двоичный CSR для отображения в память (mmap). Все секции выровнены по
+// 8 байт, порядок байтов - платформы (little-endian на x86/ARM); смещения
+// секций отсчитываются от начала файла, 0 - секции нет.
+struct CSRFileHeader {
+    char magic[8];                   // "RGGCSR01"
+    std::uint64_t numVertices;
+    std::uint64_t numSlots;          // длина массива соседей (2 * число ребер)
+    std::uint64_t offsetsPos;        // int64[numVertices + 1]
+    std::uint64_t neighborsPos;      // uint32[numSlots]
+    std::uint64_t weightsPos;        // float[numSlots]
+    std::uint64_t probabilitiesPos;  // float[numSlots]
+    std::uint64_t pointsPos;         // double[2 * numVertices]: x, y
+};
+
+inline bool writeBinaryCSR(const std::string& filename, const std::vector<Point>& points,
+                           const CSRGraph& graph) {
+    OutputStream out(filename, false);
+    if (!out.isOpen()) return false;
+    
+    std::uint64_t n = graph.numVertices(), slots = graph.neighbors.size();
+    auto aligned = [](std::uint64_t size) { return (size + 7) & ~std::uint64_t(7); };
+    CSRFileHeader header{};
+    std::memcpy(header.magic, "RGGCSR01", 8);
+    header.numVertices = n;
+    header.numSlots = slots;
+    std::uint64_t pos = sizeof(CSRFileHeader);
+    header.offsetsPos = pos;
+    pos += aligned((n + 1) * sizeof(std::int64_t));
+    header.neighborsPos = pos;
+    pos += aligned(slots * sizeof(std::uint32_t));
+    if (!graph.weights.empty()) {
+        header.weightsPos = pos;
+        pos += aligned(slots * sizeof(float));
+    }
+    if (!graph.probabilities.empty()) {
+        header.probabilitiesPos = pos;
+        pos += aligned(slots * sizeof(float));
+    }
+    header.pointsPos = pos;
+    
+    static const char padding[8] = {};
+    auto section = [&](const void* data, std::uint64_t size) {
+        out.write(static_cast<const char*>(data), size);
+        out.write(padding, aligned(size) - size);
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    section(graph.offset.data(), (n + 1) * sizeof(std::int64_t));
+    section(graph.neighbors.data(), slots * sizeof(std::uint32_t));
+    if (header.weightsPos) section(graph.weights.data(), slots * sizeof(float));
+    if (header.probabilitiesPos) section(graph.probabilities.data(), slots * sizeof(float));
+    for (const auto& p : points) {
+        double xy[2] = {p.x, p.y};
+        out.write(reinterpret_cast<const char*>(xy), sizeof(xy));
+    }
+    return out.close();
+}
+
+// Двоичный CSR, отображенный в память только для чтения: массивы читаются
+// прямо из файла без копирования
+class MappedCSR {
+private:
+    void* data = MAP_FAILED;
+    size_t size = 0;
+    const CSRFileHeader* header = nullptr;
+    
+    template <typename T>
+    const T* at(std::uint64_t pos) const {
+        return pos ? reinterpret_cast<const T*>(static_cast<const char*>(data) + pos) : nullptr;
+    }
+    
+    // Секция из count элементов по смещению pos целиком лежит в файле после
+    // заголовка и выровнена; pos = 0 допустим только для необязательных секций
+    bool fits(std::uint64_t pos, std::uint64_t count, std::uint64_t element, bool optional) const {
+        if (pos == 0) return optional;
+        if (pos < sizeof(CSRFileHeader) || pos % 8 != 0 || pos > size) return false;
+        return count <= (size - pos) / element;
+    }
+    
+    // Заголовок и индекс не должны выводить чтение за пределы отображения:
+    // до открытия проверяются размеры и смещения секций, неубывание offsets
+    // от 0 до numSlots и номера соседей (< numVertices) - один проход O(n + m)
+    bool valid(const CSRFileHeader& h) const {
+        if (std::memcmp(h.magic, "RGGCSR01", 8) != 0) return false;
+        if (h.numVertices > (std::uint64_t)std::numeric_limits<int>::max()) return false;
+        const std::uint64_t n = h.numVertices, slots = h.numSlots;
+        if (!fits(h.offsetsPos, n + 1, sizeof(std::int64_t), false) ||
+            !fits(h.neighborsPos, slots, sizeof(std::uint32_t), false) ||
+            !fits(h.weightsPos, slots, sizeof(float), true) ||
+            !fits(h.probabilitiesPos, slots, sizeof(float), true) ||
+            !fits(h.pointsPos, 2 * n, sizeof(double), false)) {
+            return false;
+        }
+        const std::int64_t* offset = at<std::int64_t>(h.offsetsPos);
+        if (offset[0] != 0 || offset[n] != (std::int64_t)slots) return false;
+        for (std::uint64_t v = 0; v < n; ++v) {
+            if (offset[v] > offset[v + 1]) return false;
+        }
+        const std::uint32_t* neighbors = at<std::uint32_t>(h.neighborsPos);
+        for (std::uint64_t k = 0; k < slots; ++k) {
+            if (neighbors[k] >= n) return false;
+        }
+        return true;
+    }
+
+public:
+    explicit MappedCSR(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(CSRFileHeader)) {
+            size = info.st_size;
+            data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (data == MAP_FAILED) return;
+        if (valid(*static_cast<const CSRFileHeader*>(data))) {
+            header = static_cast<const CSRFileHeader*>(data);
+        }
+    }
+    
+    ~MappedCSR() {
+        if (data != MAP_FAILED) munmap(data, size);
+    }
+    
+    MappedCSR(const MappedCSR&) = delete;
+    MappedCSR& operator=(const MappedCSR&) = delete;
+    
+    bool isOpen() const { return header != nullptr; }
+    int numVertices() const { return (int)header->numVertices; }
+    std::int64_t numEdges() const { return (std::int64_t)header->numSlots / 2; }
+    const std::int64_t* offsets() const { return at<std::int64_t>(header->offsetsPos); }
+    const std::uint32_t* begin(int v) const { return at<std::uint32_t>(header->neighborsPos) + offsets()[v]; }
+    const std::uint32_t* end(int v) const { return at<std::uint32_t>(header->neighborsPos) + offsets()[v + 1]; }
+    const float* weights() const { return at<float>(header->weightsPos); }              // nullptr - нет
+    const float* probabilities() const { return at<float>(header->probabilitiesPos); }  // nullptr - нет
+    Point point(int v) const {
+        const double* xy = at<double>(header->pointsPos) + 2 * v;
+        return Point(xy[0], xy[1]);
+    }
+};
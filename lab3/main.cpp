@@ -3,34 +3,54 @@
 #include <cmath>
 #include <random>
 #include <algorithm>
-#include <queue>
+#include <atomic>
 #include <limits>
-#include "matplotlibcpp.h"
-
-namespace plt = matplotlibcpp;
-
-struct Point {
-    double x, y;
-    Point(double x = 0, double y = 0) : x(x), y(y) {}
-};
-
-struct Edge {
-    int from, to;
-    double weight;
-    double probability;
-    Edge(int f, int t, double w, double p) : from(f), to(t), weight(w), probability(p) {}
-};
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include "bfs.h"
+#include "csr_graph.h"
+#include "diameter.h"
+#include "distance_sketch.h"
+#include "geometry.h"
+#include "graph_io.h"
+#include "parallel.h"
+#include "renderer.h"
+#include "shortest_paths.h"
+#include "spanning_tree.h"
+#include "spatial_grid.h"
+#include "statistics.h"
+#include "union_find.h"
 
 class Graph {
 private:
     std::vector<Point> points;
-    std::vector<std::vector<Edge>> adjacencyList;
+    CSRGraph adjacency;                  // ребра (CSR)
     int numPoints;
+    bool storeWeights = false;           // хранить длины ребер (иначе - по координатам)
+    bool storeProbabilities = false;     // хранить вероятности ребер
+    mutable double cachedDiameter = -1;  // -1 - диаметр не вычислен
+    mutable std::vector<int> cachedComponents;  // размеры компонент по убыванию (пусто - не вычислены)
+    mutable double cachedWeightedDiameter = -1;  // -1 - не вычислен
+    mutable std::vector<float> cachedLengths;    // длины ребер, если они не хранятся в CSR
+    mutable SpanningForest cachedForest;         // пустой tree.offset - лес не построен
     
 public:
     Graph(int n) : numPoints(n) {
         points.reserve(n);
-        adjacencyList.resize(n);
+        adjacency.offset.assign(n + 1, 0);
+    }
+    
+    // Какие атрибуты ребер хранить при следующем построении
+    void setEdgeAttributes(bool weights, bool probabilities) {
+        storeWeights = weights;
+        storeProbabilities = probabilities;
     }
     
     void addPoint(const Point& p) {
@@ -43,246 +63,813 @@ public:
         return std::sqrt(dx*dx + dy*dy);
     }
     
-    void buildGraph(double a, double b, const std::string& probabilityType) {
-        adjacencyList.clear();
-        adjacencyList.resize(numPoints);
+    // Длина k-го элемента массива соседей (ребро v-u)
+    double edgeWeight(int v, int u, std::int64_t k) const {
+        return adjacency.weights.empty() ? distance(v, u) : adjacency.weights[k];
+    }
+    
+    // Ребро, принятое генератором (from < to)
+    struct Candidate {
+        int from, to;
+        float weight, probability;
+    };
+    
+    // Генерация ребер случайного геометрического графа. Ребро (i, j) появляется
+    // с вероятностью exp(-a*d^b) ("exp") или 1/d^b (иначе).
+    // Рассматриваются только пары не дальше maxDistance и с вероятностью не
+    // меньше minProbability: точки раскладываются по равномерной сетке и
+    // сравниваются только с соседними ячейками. Ячейки обрабатываются
+    // параллельно, у каждой ячейки свой поток случайных чисел, поэтому
+    // граф определяется seed (любым, включая 0) и не зависит от числа потоков.
+    //
+    // Пары двух ячеек не перебираются по одной: по наибольшей для этих
+    // ячеек вероятности pmax выбираются кандидаты с геометрическими пропусками,
+    // а кандидат принимается с вероятностью p(d)/pmax. Каждая пара попадает
+    // в граф независимо с вероятностью p(d), а работа пропорциональна числу
+    // кандидатов, т.е. числу ребер, а не числу пар. Без maxDistance и
+    // minProbability радиуса нет и к этому добавляется O(ячеек^2) на
+    // просмотр всех пар ячеек (см. SpatialGrid::halfStencil).
+    //
+    // Каждое принятое ребро передается в emit(thread, candidate) из потока
+    // thread; порядок вызовов зависит от распределения ячеек по потокам.
+    template <typename Emit>
+    void generateEdges(double a, double b, const std::string& probabilityType,
+                       double maxDistance, double minProbability,
+                       std::uint64_t seed, int threads, Emit emit) const {
+        const bool expModel = (probabilityType == "exp");
         
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(0.0, 1.0);
+        // Радиус, за которым вероятность меньше minProbability
+        double radius = maxDistance;
+        if (minProbability > 0 && minProbability < 1 && b > 0) {
+            double cutoff = expModel ? std::pow(-std::log(minProbability) / a, 1.0 / b)
+                                     : std::pow(minProbability, -1.0 / b);
+            radius = radius > 0 ? std::min(radius, cutoff) : cutoff;
+        }
         
-        for (int i = 0; i < numPoints; ++i) {
-            for (int j = i + 1; j < numPoints; ++j) {
-                double d = distance(i, j);
-                double prob;
-                
-                if (probabilityType == "exp") {
-                    prob = std::exp(-a * std::pow(d, b));
-                } else { // inverse power
-                    prob = 1.0 / std::pow(d, b);
-                }
-                
-                // Случайное решение о добавлении ребра
-                if (dis(gen) < prob) {
-                    adjacencyList[i].emplace_back(i, j, d, prob);
-                    adjacencyList[j].emplace_back(j, i, d, prob);
-                }
+        // Вероятность ребра по квадрату расстояния: d^b = exp(b/2 * ln d^2)
+        const double halfB = b / 2;
+        auto probability = [&](double d2) {
+            double db = std::exp(halfB * std::log(d2));
+            return expModel ? std::exp(-a * db) : 1.0 / db;
+        };
+        
+        SpatialGrid grid(points, radius, 16);
+        const double radius2 = radius > 0 ? radius * radius : std::numeric_limits<double>::infinity();
+        
+        // Наибольшая вероятность для пар ячеек со сдвигом из шаблона
+        // (вероятность монотонна по расстоянию, поэтому максимум на краях);
+        // сдвиги с нулевой вероятностью исключаются
+        std::vector<std::pair<int, int>> stencil;
+        std::vector<double> stencilMax;
+        for (const auto& [dx, dy] : grid.halfStencil(radius)) {
+            double near = grid.minGap(dx, dy), far = grid.maxGap(dx, dy);
+            double pmax = std::min(1.0, std::max(probability(near * near), probability(far * far)));
+            if (pmax > 0) {
+                stencil.emplace_back(dx, dy);
+                stencilMax.push_back(pmax);
             }
         }
-    }
-    
-    void applyConstraints(int maxDegree = -1, double maxDistance = -1) {
-        if (maxDegree <= 0 && maxDistance <= 0) return;
         
-        std::vector<std::vector<Edge>> newAdjacencyList(numPoints);
-        
-        for (int i = 0; i < numPoints; ++i) {
-            for (const auto& edge : adjacencyList[i]) {
-                if (edge.from < edge.to) { // Обрабатываем каждое ребро один раз
-                    bool keepEdge = true;
+        parallelFor(grid.numCells(), threads, 64, [&](int begin, int end, int thread) {
+            for (int c = begin; c < end; ++c) {
+                const int* cellI = grid.cellBegin(c);
+                long long sizeI = grid.cellEnd(c) - cellI;
+                if (sizeI == 0) continue;
+                SplitMix64 rng(seed, c);
+                int cx = c % grid.columns(), cy = c / grid.columns();
+                
+                for (size_t s = 0; s < stencil.size(); ++s) {
+                    auto [dx, dy] = stencil[s];
+                    int nx = cx + dx, ny = cy + dy;
+                    if (nx < 0 || nx >= grid.columns() || ny >= grid.rows()) continue;
+                    int other = ny * grid.columns() + nx;
+                    const int* cellJ = grid.cellBegin(other);
+                    long long sizeJ = grid.cellEnd(other) - cellJ;
                     
-                    // Проверка на максимальное расстояние
-                    if (maxDistance > 0 && edge.weight > maxDistance) {
-                        keepEdge = false;
-                    }
+                    // Пары нумеруются k = 0..pairs-1: внутри ячейки - верхний
+                    // треугольник по строкам, для двух ячеек - по строкам sizeI x sizeJ
+                    const bool same = (other == c);
+                    long long pairs = same ? sizeI * (sizeI - 1) / 2 : sizeI * sizeJ;
+                    double pmax = stencilMax[s];
+                    if (pairs == 0) continue;
+                    double logSkip = (pmax < 1) ? std::log1p(-pmax) : 0;
                     
-                    // Проверка на максимальную степень
-                    if (maxDegree > 0) {
-                        int degree1 = adjacencyList[edge.from].size();
-                        int degree2 = adjacencyList[edge.to].size();
+                    long long k = -1;
+                    long long row = 0, rowStart = 0; // строка треугольника и ее первый номер
+                    for (;;) {
+                        k += 1;
+                        if (pmax < 1) {
+                            double skip = std::floor(std::log1p(-rng.uniform()) / logSkip);
+                            if (skip >= (double)(pairs - k)) break;
+                            k += (long long)skip;
+                        }
+                        if (k >= pairs) break;
                         
-                        if (degree1 > maxDegree || degree2 > maxDegree) {
-                            keepEdge = false;
+                        int pi, pj;
+                        if (same) {
+                            while (k >= rowStart + (sizeI - 1 - row)) {
+                                rowStart += sizeI - 1 - row;
+                                ++row;
+                            }
+                            pi = cellI[row];
+                            pj = cellI[row + 1 + (k - rowStart)];
+                        } else {
+                            pi = cellI[k / sizeJ];
+                            pj = cellJ[k % sizeJ];
+                        }
+                        
+                        double ddx = points[pi].x - points[pj].x;
+                        double ddy = points[pi].y - points[pj].y;
+                        double d2 = ddx * ddx + ddy * ddy;
+                        if (d2 > radius2) continue;
+                        
+                        // Случайное решение о добавлении ребра (прореживание)
+                        double prob = probability(d2);
+                        if (pmax == 1 ? rng.uniform() < prob : rng.uniform() * pmax < prob) {
+                            emit(thread, Candidate{std::min(pi, pj), std::max(pi, pj),
+                                                   (float)std::sqrt(d2), (float)prob});
                         }
-                    }
-                    
-                    if (keepEdge) {
-                        newAdjacencyList[edge.from].push_back(edge);
-                        newAdjacencyList[edge.to].emplace_back(edge.to, edge.from, edge.weight, edge.probability);
                     }
                 }
             }
-        }
-        
-        adjacencyList = newAdjacencyList;
+        });
     }
     
-    std::vector<int> bfs(int start) const {
-        std::vector<int> dist(numPoints, -1);
-        std::queue<int> q;
+    // Построение графа в CSR (см. generateEdges); компоненты связности
+    // собираются прямо при генерации ребер
+    void buildGraph(double a, double b, const std::string& probabilityType,
+                    double maxDistance = -1, double minProbability = 0,
+                    std::uint64_t seed = 0, int threads = 0) {
+        cachedDiameter = -1;
+        cachedComponents.clear();
+        cachedWeightedDiameter = -1;
+        cachedLengths.clear();
+        cachedForest = SpanningForest();
+        if (threads <= 0) threads = defaultThreadCount();
         
-        dist[start] = 0;
-        q.push(start);
+        std::vector<std::vector<Candidate>> buffers(threads);
+        ConcurrentUnionFind sets(numPoints);
+        generateEdges(a, b, probabilityType, maxDistance, minProbability, seed, threads,
+                      [&](int thread, const Candidate& e) {
+                          buffers[thread].push_back(e);
+                          sets.unite(e.from, e.to);
+                      });
         
-        while (!q.empty()) {
-            int current = q.front();
-            q.pop();
-            
-            for (const auto& edge : adjacencyList[current]) {
-                if (dist[edge.to] == -1) {
-                    dist[edge.to] = dist[current] + 1;
-                    q.push(edge.to);
+        // Слияние буферов потоков в CSR: подсчет степеней, затем заполнение
+        std::vector<std::int64_t>& offset = adjacency.offset;
+        offset.assign(numPoints + 1, 0);
+        for (const auto& buffer : buffers) {
+            for (const auto& e : buffer) {
+                offset[e.from + 1]++;
+                offset[e.to + 1]++;
+            }
+        }
+        for (int i = 0; i < numPoints; ++i) offset[i + 1] += offset[i];
+        
+        adjacency.neighbors.assign(offset[numPoints], 0);
+        adjacency.weights.assign(storeWeights ? offset[numPoints] : 0, 0);
+        adjacency.probabilities.assign(storeProbabilities ? offset[numPoints] : 0, 0);
+        std::vector<std::int64_t> pos(offset.begin(), offset.end() - 1);
+        for (auto& buffer : buffers) {
+            for (const auto& e : buffer) {
+                for (auto [v, u] : {std::make_pair(e.from, e.to), std::make_pair(e.to, e.from)}) {
+                    std::int64_t k = pos[v]++;
+                    adjacency.neighbors[k] = u;
+                    if (storeWeights) adjacency.weights[k] = e.weight;
+                    if (storeProbabilities) adjacency.probabilities[k] = e.probability;
                 }
             }
+            std::vector<Candidate>().swap(buffer);
         }
         
-        return dist;
+        // Порядок соседей не зависит от распределения ячеек по потокам
+        adjacency.sortNeighbors(threads);
+        cachedComponents = sets.componentSizes();
     }
     
-    double computeDiameter() const {
-        double maxDist = 0;
+    // Генерация графа прямо в writer без построения CSR: у каждого потока
+    // буфер ограниченного размера, заполненный буфер сбрасывается в writer
+    // под общей блокировкой. Память не зависит от числа ребер, а набор ребер
+    // совпадает с buildGraph при том же seed (порядок строк - нет).
+    bool streamGraph(GraphWriter& writer, double a, double b, const std::string& probabilityType,
+                     double maxDistance = -1, double minProbability = 0,
+                     std::uint64_t seed = 0, int threads = 0) const {
+        if (threads <= 0) threads = defaultThreadCount();
+        const size_t FLUSH = 1 << 14;
         
-        for (int i = 0; i < numPoints; ++i) {
-            auto dist = bfs(i);
-            for (int j = 0; j < numPoints; ++j) {
-                if (dist[j] > maxDist) {
-                    maxDist = dist[j];
+        writer.begin(points);
+        std::mutex writerMutex;
+        std::vector<std::vector<Candidate>> buffers(threads);
+        auto flush = [&](std::vector<Candidate>& buffer) {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            for (const auto& e : buffer) writer.edge(e.from, e.to, e.weight, e.probability);
+            buffer.clear();
+        };
+        generateEdges(a, b, probabilityType, maxDistance, minProbability, seed, threads,
+                      [&](int thread, const Candidate& e) {
+                          buffers[thread].push_back(e);
+                          if (buffers[thread].size() >= FLUSH) flush(buffers[thread]);
+                      });
+        for (auto& buffer : buffers) flush(buffer);
+        return writer.end();
+    }
+    
+    // Запись графа в файл: .csr - двоичный CSR для mmap, иначе потоковый
+    // формат по расширению (.graphml, .dot, список ребер, .gz - сжатый)
+    bool save(const std::string& filename) const {
+        if (hasSuffix(filename, ".csr")) {
+            return writeBinaryCSR(filename, points, adjacency);
+        }
+        std::unique_ptr<GraphWriter> writer = makeGraphWriter(filename);
+        if (!writer) return false;
+        writer->begin(points);
+        for (int v = 0; v < numPoints; ++v) {
+            for (std::int64_t k = adjacency.offset[v]; k < adjacency.offset[v + 1]; ++k) {
+                std::uint32_t u = adjacency.neighbors[k];
+                if ((int)u < v) continue;
+                float probability = adjacency.probabilities.empty() ? std::nanf("") : adjacency.probabilities[k];
+                writer->edge(v, u, (float)edgeWeight(v, u, k), probability);
+            }
+        }
+        return writer->end();
+    }
+    
+    // Совпадает ли отображенный двоичный CSR с графом (проверка save после записи)
+    bool matches(const MappedCSR& file) const {
+        if (!file.isOpen() || file.numVertices() != numPoints) return false;
+        const size_t slots = adjacency.neighbors.size();
+        auto same = [](const auto* stored, const auto& values) {
+            return stored ? values.size() > 0 && std::equal(values.begin(), values.end(), stored)
+                          : values.empty();
+        };
+        if ((size_t)file.numEdges() * 2 != slots ||
+            !std::equal(adjacency.offset.begin(), adjacency.offset.end(), file.offsets()) ||
+            !std::equal(adjacency.neighbors.begin(), adjacency.neighbors.end(), file.begin(0)) ||
+            !same(file.weights(), adjacency.weights) ||
+            !same(file.probabilities(), adjacency.probabilities)) {
+            return false;
+        }
+        for (int v = 0; v < numPoints; ++v) {
+            Point p = file.point(v);
+            if (p.x != points[v].x || p.y != points[v].y) return false;
+        }
+        return true;
+    }
+    
+    // Порядок рассмотрения ребер при ограничении степени
+    enum class EdgeOrder {
+        Shortest,   // сначала короткие ребра
+        Random      // случайный порядок, зависит только от seed и концов ребра
+    };
+    
+    // Ограничения на степень и длину ребер. Ребра длиннее maxDistance
+    // удаляются, остальные рассматриваются в порядке order и остаются, пока
+    // у обоих концов степень меньше maxDegree (жадный отбор со счетчиками
+    // степеней). При threads > 1 ребра делятся между потоками блоками в порядке
+    // приоритета, а место в степени резервируется атомарными счетчиками;
+    // ребра, отвергнутые параллельным проходом, затем пересматриваются
+    // последовательно, поэтому ни одно допустимое ребро не теряется.
+    // Ребра удаляются сжатием CSR на месте; списки соседей должны быть
+    // отсортированы, как после buildGraph.
+    void applyConstraints(int maxDegree = -1, double maxDistance = -1,
+                          EdgeOrder order = EdgeOrder::Shortest, std::uint64_t seed = 0,
+                          int threads = 1) {
+        if (maxDegree <= 0 && maxDistance <= 0) return;
+        cachedDiameter = -1;
+        cachedComponents.clear();
+        cachedWeightedDiameter = -1;
+        cachedLengths.clear();
+        cachedForest = SpanningForest();
+        if (threads <= 0) threads = defaultThreadCount();
+        
+        // Ребра v < u с позициями обеих копий в CSR. Соседи u, меньшие u,
+        // стоят в начале его списка по возрастанию, поэтому вторая копия -
+        // очередная позиция курсора u.
+        struct Ranked {
+            double key;
+            std::int64_t slot, twin;
+            std::uint32_t v, u;
+        };
+        std::vector<Ranked> edges;
+        edges.reserve(adjacency.numEdges());
+        std::vector<std::int64_t> cursor(numPoints, 0);
+        for (int v = 0; v < numPoints; ++v) {
+            for (std::int64_t k = adjacency.offset[v]; k < adjacency.offset[v + 1]; ++k) {
+                std::uint32_t u = adjacency.neighbors[k];
+                if ((int)u < v) continue;
+                std::int64_t twin = adjacency.offset[u] + cursor[u]++;
+                double length = edgeWeight(v, u, k);
+                if (maxDistance > 0 && length > maxDistance) continue;
+                double key = order == EdgeOrder::Shortest
+                                 ? length
+                                 : SplitMix64(seed, (std::uint64_t)v << 32 | u).uniform();
+                edges.push_back({key, k, twin, (std::uint32_t)v, u});
+            }
+        }
+        
+        std::vector<char> accepted(edges.size(), 1);
+        if (maxDegree > 0) {
+            std::sort(edges.begin(), edges.end(), [](const Ranked& x, const Ranked& y) {
+                return x.key != y.key ? x.key < y.key : x.slot < y.slot;
+            });
+            
+            std::vector<int> degree(numPoints, 0);
+            auto sequential = [&](bool retryOnly) {
+                for (size_t i = 0; i < edges.size(); ++i) {
+                    if (retryOnly && accepted[i]) continue;
+                    const Ranked& e = edges[i];
+                    accepted[i] = degree[e.v] < maxDegree && degree[e.u] < maxDegree;
+                    if (accepted[i]) {
+                        ++degree[e.v];
+                        ++degree[e.u];
+                    }
                 }
+            };
+            
+            if (threads == 1) {
+                sequential(false);
+            } else {
+                std::vector<std::atomic<int>> counters(numPoints);
+                for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+                auto reserve = [&](std::atomic<int>& c) {
+                    int current = c.load(std::memory_order_relaxed);
+                    while (current < maxDegree) {
+                        if (c.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) {
+                            return true;
+                        }
+                    }
+                    return false;
+                };
+                parallelFor((int)edges.size(), threads, 4096, [&](int begin, int end, int) {
+                    for (int i = begin; i < end; ++i) {
+                        const Ranked& e = edges[i];
+                        bool ok = reserve(counters[e.v]);
+                        if (ok && !reserve(counters[e.u])) {
+                            counters[e.v].fetch_sub(1, std::memory_order_relaxed);
+                            ok = false;
+                        }
+                        accepted[i] = ok;
+                    }
+                });
+                for (int v = 0; v < numPoints; ++v) degree[v] = counters[v].load();
+                sequential(true);
             }
         }
         
-        return maxDist;
+        std::vector<char> kept(adjacency.neighbors.size(), 0);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (accepted[i]) kept[edges[i].slot] = kept[edges[i].twin] = 1;
+        }
+        adjacency.compact([&](int, std::uint32_t, std::int64_t k) { return kept[k] != 0; });
     }
     
-    std::pair<double, double> computeTreeProperties() const {
-        double diameter = computeDiameter();
-        double allowedDepth = diameter / 2.0;
-        
-        return {diameter, allowedDepth};
+    // Расстояния в ребрах от start (-1 - вершина недостижима)
+    std::vector<int> bfs(int start) const {
+        std::vector<int> dist;
+        BFSEngine(adjacency).run(start, dist);
+        return dist;
     }
     
-    void visualize(const std::string& title, const std::string& filename = "") const {
-    plt::figure_size(1000, 1000);
-    plt::title(title);
+    // Ребра графа в виде CSR
+    const CSRGraph& csr() const {
+        return adjacency;
+    }
     
-    // Рисуем вершины
-    std::vector<double> x_coords, y_coords;
-    for (const auto& p : points) {
-        x_coords.push_back(p.x);
-        y_coords.push_back(p.y);
+    // Диаметр (наибольшее конечное расстояние в ребрах) методом iFUB;
+    // результат запоминается до следующего изменения ребер
+    double computeDiameter(int threads = 0) const {
+        if (cachedDiameter < 0) {
+            cachedDiameter = DiameterSolver(adjacency, threads).solve();
+        }
+        return cachedDiameter;
     }
     
-    // Рисуем ребра
-    for (int i = 0; i < numPoints; ++i) {
-        for (const auto& edge : adjacencyList[i]) {
-            if (edge.from < edge.to) {
-                std::vector<double> x = {points[edge.from].x, points[edge.to].x};
-                std::vector<double> y = {points[edge.from].y, points[edge.to].y};
-                plt::plot(x, y, "b-");
-            }
+    // Приближенный режим для графов, где и точный диаметр слишком долог
+    // (см. DistanceSketch): границы диаметра двойным проходом, уточненные
+    // выборкой BFS или HyperANF, и распределение расстояний в ребрах. Если
+    // точный диаметр уже вычислен, границы совпадают с ним
+    enum class DistanceMethod { Sampling, HyperANF };
+    
+    struct DistanceEstimate {
+        DiameterBounds bounds;
+        DistanceDistribution distribution;
+    };
+    
+    DistanceEstimate estimateDistances(DistanceMethod method, double error = 0.05,
+                                       double confidence = 0.95,
+                                       size_t memoryLimit = (size_t)1 << 30,
+                                       std::uint64_t seed = 1, int threads = 0) const {
+        DistanceSketch sketch(adjacency, threads);
+        DistanceEstimate estimate;
+        estimate.bounds = sketch.sweepBounds();
+        if (method == DistanceMethod::Sampling) {
+            estimate.distribution = sketch.sample(error, confidence, seed, estimate.bounds);
+        } else {
+            estimate.distribution = sketch.hyperANF(error, memoryLimit, seed, estimate.bounds);
         }
+        if (cachedDiameter >= 0) estimate.bounds.lower = estimate.bounds.upper = (int)cachedDiameter;
+        return estimate;
     }
     
-    plt::scatter(x_coords, y_coords, 50);
-    plt::xlim(0, 100);
-    plt::ylim(0, 100);
+    // Размеры компонент связности по убыванию. После buildGraph они уже
+    // известны из генерации, после изменения ребер пересчитываются параллельной
+    // системой непересекающихся множеств за почти линейное время
+    const std::vector<int>& componentSizes(int threads = 0) const {
+        if (cachedComponents.empty() && numPoints > 0) {
+            cachedComponents = ConcurrentUnionFind::components(adjacency, threads);
+        }
+        return cachedComponents;
+    }
     
-    // Сохраняем в файл вместо показа
-    if (!filename.empty()) {
-        plt::save(filename);
-        std::cout << "Граф сохранен в файл: " << filename << std::endl;
-    } else {
-        // Создаем имя файла из заголовка
-        std::string safe_filename = title;
-        std::replace(safe_filename.begin(), safe_filename.end(), ' ', '_');
-        safe_filename += ".png";
-        plt::save(safe_filename);
-        std::cout << "Граф сохранен в файл: " << safe_filename << std::endl;
+    // Длины ребер параллельно массиву соседей: хранимые в CSR или
+    // вычисленные по координатам (запоминаются до изменения ребер)
+    const std::vector<float>& edgeLengths(int threads = 0) const {
+        if (!adjacency.weights.empty()) return adjacency.weights;
+        if (cachedLengths.size() != adjacency.neighbors.size()) {
+            if (threads <= 0) threads = defaultThreadCount();
+            cachedLengths.resize(adjacency.neighbors.size());
+            parallelFor(numPoints, threads, 1024, [&](int begin, int end, int) {
+                for (int v = begin; v < end; ++v) {
+                    for (std::int64_t k = adjacency.offset[v]; k < adjacency.offset[v + 1]; ++k) {
+                        cachedLengths[k] = (float)distance(v, adjacency.neighbors[k]);
+                    }
+                }
+            });
+        }
+        return cachedLengths;
     }
     
-    plt::close();
-}
+    // Длины кратчайших путей от start по длинам ребер (UNREACHABLE -
+    // недостижима): Дейкстра на radix heap в одном потоке, delta-stepping в
+    // нескольких
+    std::vector<double> shortestPaths(int start, int threads = 1) const {
+        std::vector<double> dist;
+        if (threads == 1) {
+            DijkstraEngine(adjacency, edgeLengths(1)).run(start, dist);
+        } else {
+            DeltaSteppingEngine(adjacency, edgeLengths(threads), threads).run(start, dist);
+        }
+        return dist;
+    }
     
-    void printStats() const {
-        auto [diameter, allowedDepth] = computeTreeProperties();
+    // Взвешенный диаметр (наибольшая конечная длина кратчайшего пути);
+    // запоминается до следующего изменения ребер
+    double computeWeightedDiameter(int threads = 0) const {
+        if (cachedWeightedDiameter < 0) {
+            cachedWeightedDiameter = WeightedDiameterSolver(adjacency, edgeLengths(threads), threads).solve();
+        }
+        return cachedWeightedDiameter;
+    }
+    
+    // Минимальный остовный лес по длинам ребер (параллельный Борувка);
+    // запоминается до следующего изменения ребер
+    const SpanningForest& spanningTree(int threads = 0) const {
+        if (cachedForest.tree.offset.empty()) {
+            cachedForest = BoruvkaMST(adjacency, edgeLengths(threads), threads).build();
+        }
+        return cachedForest;
+    }
+    
+    // Диаметры графа и характеристики минимального остовного дерева.
+    // Глубина дерева - высота при подвешивании за центр; у любого
+    // остовного дерева она не меньше половины диаметра графа
+    struct TreeProperties {
+        double diameter;           // в ребрах
+        double weightedDiameter;   // по длинам ребер
+        const SpanningForest& mst;  // действителен до изменения ребер
+    };
+    
+    TreeProperties computeTreeProperties(int threads = 0) const {
+        return {computeDiameter(threads), computeWeightedDiameter(threads), spanningTree(threads)};
+    }
+    
+    // Запись изображения графа в PNG или SVG (по расширению файла)
+    bool saveImage(const std::string& title, const std::string& filename, int threads = 0) const {
+        return GraphRenderer(points, adjacency).save(title, filename, threads);
+    }
+    
+    // Изображение графа с сообщением о сохранении; без имени файла
+    // оно строится из заголовка. threads - потоки растеризации одного изображения
+    void visualize(const std::string& title, const std::string& filename = "", int threads = 0) const {
+        std::string target = filename;
+        if (target.empty()) {
+            target = title;
+            std::replace(target.begin(), target.end(), ' ', '_');
+            target += ".png";
+        }
         
-        std::cout << "Диаметр графа: " << diameter << std::endl;
-        std::cout << "Допустимая глубина дерева: " << allowedDepth << std::endl;
+        if (saveImage(title, target, threads)) {
+            std::cout << "Граф сохранен в файл: " << target << std::endl;
+        } else {
+            std::cerr << "Не удалось сохранить граф в файл: " << target << std::endl;
+        }
+    }
+    
+    // Характеристики графа: диаметр, число ребер, степени вершин и компоненты
+    // связности; взвешенный диаметр и MST - только если weighted
+    struct Measures {
+        int diameter;
+        long long edges;
+        double meanDegree;
+        int maxDegree;
+        int minDegree;
+        int components;
+        int largestComponent;
+        double susceptibility;
+        bool weighted;
+        double weightedDiameter;
+        double mstWeight;
+        int mstDepth;            // глубина MST от центра в ребрах
+    };
+    
+    Measures measure(int threads = 0, bool weighted = false) const {
+        Measures m{};
+        m.diameter = (int)computeDiameter(threads);
+        m.edges = adjacency.numEdges();
+        m.meanDegree = numPoints ? static_cast<double>(m.edges * 2) / numPoints : 0;
+        m.maxDegree = 0;
+        m.minDegree = numPoints ? std::numeric_limits<int>::max() : 0;
+        for (int i = 0; i < numPoints; ++i) {
+            m.maxDegree = std::max(m.maxDegree, adjacency.degree(i));
+            m.minDegree = std::min(m.minDegree, adjacency.degree(i));
+        }
         
-        // Статистика по степеням вершин
-        std::vector<int> degrees(numPoints);
-        int totalEdges = 0;
+        // Восприимчивость - средний размер кластера без наибольшей компоненты,
+        // sum(s^2) / n; ее пик указывает на порог перколяции
+        const std::vector<int>& sizes = componentSizes(threads);
+        m.components = (int)sizes.size();
+        m.largestComponent = sizes.empty() ? 0 : sizes[0];
+        double squares = 0;
+        for (size_t i = 1; i < sizes.size(); ++i) squares += (double)sizes[i] * sizes[i];
+        m.susceptibility = numPoints ? squares / numPoints : 0;
         
-        for (int i = 0; i < numPoints; ++i) {
-            degrees[i] = adjacencyList[i].size();
-            totalEdges += degrees[i];
+        m.weighted = weighted;
+        if (weighted) {
+            m.weightedDiameter = computeWeightedDiameter(threads);
+            const SpanningForest& mst = spanningTree(threads);
+            m.mstWeight = mst.weight;
+            m.mstDepth = mst.depth;
         }
+        return m;
+    }
+    
+    void printStats() const {
+        TreeProperties tree = computeTreeProperties();
+        const SpanningForest& mst = tree.mst;
+        
+        std::cout << "Диаметр графа: " << tree.diameter << std::endl;
+        std::cout << "Взвешенный диаметр графа: " << tree.weightedDiameter << std::endl;
+        std::cout << "Минимальное остовное дерево: вес " << mst.weight
+                  << ", диаметр " << mst.hopDiameter << " ребер (" << mst.weightedDiameter << ")"
+                  << std::endl;
+        std::cout << "Глубина дерева от центра: " << mst.depth << " ребер (" << mst.weightedDepth
+                  << "), нижняя граница " << std::ceil(tree.diameter / 2.0) << std::endl;
         
-        totalEdges /= 2; // Каждое ребро посчитано дважды
+        // Статистика по степеням вершин
+        Measures m = measure();
+        std::cout << "Количество ребер: " << m.edges << std::endl;
+        std::cout << "Средняя степень: " << m.meanDegree << std::endl;
+        std::cout << "Максимальная степень: " << m.maxDegree << std::endl;
+        std::cout << "Минимальная степень: " << m.minDegree << std::endl;
         
-        std::cout << "Количество ребер: " << totalEdges << std::endl;
-        std::cout << "Средняя степень: " << static_cast<double>(totalEdges * 2) / numPoints << std::endl;
-        std::cout << "Максимальная степень: " << *std::max_element(degrees.begin(), degrees.end()) << std::endl;
-        std::cout << "Минимальная степень: " << *std::min_element(degrees.begin(), degrees.end()) << std::endl;
+        // Компоненты связности: число, доля наибольшей и распределение размеров
+        std::cout << "Компонент связности: " << m.components << std::endl;
+        std::cout << "Доля наибольшей компоненты: "
+                  << (numPoints ? (double)m.largestComponent / numPoints : 0) << std::endl;
+        std::cout << "Размеры компонент (размер x количество):";
+        const std::vector<int>& sizes = componentSizes();
+        for (size_t i = 0; i < sizes.size();) {
+            size_t j = i;
+            while (j < sizes.size() && sizes[j] == sizes[i]) ++j;
+            std::cout << ' ' << sizes[i] << 'x' << j - i;
+            i = j;
+        }
+        std::cout << std::endl;
+        if (m.components > 1) {
+            std::cout << "Граф несвязный: диаметр - наибольший среди компонент" << std::endl;
+        }
+    }
+};
+
+// Паттерн графов: диапазоны параметров, модель вероятности и ограничения
+struct PatternSpec {
+    std::string name;
+    double aMin, aMax;
+    double bMin, bMax;
+    std::string probType;
+    int maxDegree;        // -1 - без ограничения
+    double maxDistance;   // -1 - без ограничения
+};
+
+// Итоги серии графов одного паттерна
+struct EnsembleSummary {
+    RunningStats diameter, edges, meanDegree, maxDegree, minDegree;
+    RunningStats components, giantFraction;  // число компонент и доля вершин в наибольшей
+    RunningStats susceptibility;             // средний размер кластера без наибольшей
+    RunningStats weightedDiameter, mstWeight, mstDepth;  // только при weighted
+    
+    void add(const Graph::Measures& m, int numPoints) {
+        diameter.add(m.diameter);
+        edges.add(m.edges);
+        meanDegree.add(m.meanDegree);
+        maxDegree.add(m.maxDegree);
+        minDegree.add(m.minDegree);
+        components.add(m.components);
+        giantFraction.add(numPoints ? (double)m.largestComponent / numPoints : 0);
+        susceptibility.add(m.susceptibility);
+        if (m.weighted) {
+            weightedDiameter.add(m.weightedDiameter);
+            mstWeight.add(m.mstWeight);
+            mstDepth.add(m.mstDepth);
+        }
+    }
+    
+    void merge(const EnsembleSummary& other) {
+        diameter.merge(other.diameter);
+        edges.merge(other.edges);
+        meanDegree.merge(other.meanDegree);
+        maxDegree.merge(other.maxDegree);
+        minDegree.merge(other.minDegree);
+        components.merge(other.components);
+        giantFraction.merge(other.giantFraction);
+        susceptibility.merge(other.susceptibility);
+        weightedDiameter.merge(other.weightedDiameter);
+        mstWeight.merge(other.mstWeight);
+        mstDepth.merge(other.mstDepth);
+    }
+    
+    void print() const {
+        auto line = [](const char* name, const RunningStats& st) {
+            std::cout << "  " << name << ": " << st.mean() << " +- " << st.confidenceHalfWidth()
+                      << " (СКО " << st.stddev() << ", от " << st.min() << " до " << st.max() << ")"
+                      << std::endl;
+        };
+        std::cout << "  Графов: " << diameter.count() << std::endl;
+        line("Диаметр", diameter);
+        line("Ребер", edges);
+        line("Средняя степень", meanDegree);
+        line("Максимальная степень", maxDegree);
+        line("Минимальная степень", minDegree);
+        line("Компонент связности", components);
+        line("Доля наибольшей компоненты", giantFraction);
+        line("Восприимчивость", susceptibility);
+        if (weightedDiameter.count() > 0) {
+            line("Взвешенный диаметр", weightedDiameter);
+            line("Вес MST", mstWeight);
+            line("Глубина MST", mstDepth);
+        }
     }
 };
 
 class GraphGenerator {
 private:
-    std::vector<Point> generateRandomPoints(int numPoints) {
+    std::mt19937 gen;
+    
+    template <typename Rng>
+    static std::vector<Point> generateRandomPoints(int numPoints, Rng& rng) {
         std::vector<Point> points;
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        points.reserve(numPoints);
         std::uniform_real_distribution<> dis(0.0, 100.0);
         
         for (int i = 0; i < numPoints; ++i) {
-            points.emplace_back(dis(gen), dis(gen));
+            points.emplace_back(dis(rng), dis(rng));
         }
         
         return points;
     }
     
+    // Граф паттерна по заданному генератору: точки, параметры a и b, ребра
+    // и ограничения. threads - потоки построения одного графа.
+    template <typename Rng>
+    static Graph generateGraph(const PatternSpec& spec, int numPoints, Rng& rng,
+                               std::uint64_t seed, int threads, double& a, double& b) {
+        Graph g(numPoints);
+        for (const auto& p : generateRandomPoints(numPoints, rng)) {
+            g.addPoint(p);
+        }
+        
+        std::uniform_real_distribution<> aDis(spec.aMin, spec.aMax);
+        std::uniform_real_distribution<> bDis(spec.bMin, spec.bMax);
+        a = aDis(rng);
+        b = bDis(rng);
+        
+        // Ограничение расстояния учитывается уже при построении
+        g.buildGraph(a, b, spec.probType, spec.maxDistance, 0, seed, threads);
+        g.applyConstraints(spec.maxDegree, spec.maxDistance);
+        return g;
+    }
+    
 public:
+    GraphGenerator() : gen(std::random_device()()) {}
+    
+    // Паттерн по имени: ограничения степени и расстояния
+    static PatternSpec makePattern(const std::string& patternName,
+                                   const std::vector<double>& aValues,
+                                   const std::vector<double>& bValues,
+                                   const std::string& probType) {
+        PatternSpec spec{patternName, aValues[0], aValues[1], bValues[0], bValues[1],
+                         probType, -1, -1};
+        if (patternName == "Pattern1_Exp_LowDensity") {
+            spec.maxDegree = 5; spec.maxDistance = 30;
+        } else if (patternName == "Pattern2_Exp_HighDensity") {
+            spec.maxDegree = 15; spec.maxDistance = 50;
+        } else if (patternName == "Pattern3_Inverse_LowDensity") {
+            spec.maxDegree = 5; spec.maxDistance = 30;
+        } else if (patternName == "Pattern4_Inverse_HighDensity") {
+            spec.maxDegree = 15; spec.maxDistance = 50;
+        }
+        return spec;
+    }
+    
     std::vector<Graph> generatePattern(const std::string& patternName, 
                                         const std::vector<double>& aValues,
                                         const std::vector<double>& bValues,
                                         const std::string& probType,
                                         int numPoints = 100,
                                         int graphsPerPattern = 5) {
+        PatternSpec spec = makePattern(patternName, aValues, bValues, probType);
         std::vector<Graph> graphs;
+        graphs.reserve(graphsPerPattern);
         
         for (int i = 0; i < graphsPerPattern; ++i) {
-            // Генерируем случайные точки
-            auto points = generateRandomPoints(numPoints);
-            
-            // Создаем граф с этими точками
-            Graph g(numPoints);
-            for (const auto& p : points) {
-                g.addPoint(p);
-            }
-            
-            // Выбираем случайные параметры из заданного диапазона
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<> aDis(aValues[0], aValues[1]);
-            std::uniform_real_distribution<> bDis(bValues[0], bValues[1]);
-            
-            double a = aDis(gen);
-            double b = bDis(gen);
+            double a, b;
+            std::uint64_t seed = (std::uint64_t)gen() << 32 | gen();
+            Graph g = generateGraph(spec, numPoints, gen, seed, 0, a, b);
             
             std::cout << "\n=== Паттерн: " << patternName << ", Граф " << i+1 << " ===" << std::endl;
             std::cout << "Параметры: a = " << a << ", b = " << b << std::endl;
             
-            g.buildGraph(a, b, probType);
-            
-            // Применяем ограничения в зависимости от паттерна
-            if (patternName == "Pattern1_Exp_LowDensity") {
-                g.applyConstraints(5, 30); // ограничение степени и расстояния
-            } else if (patternName == "Pattern2_Exp_HighDensity") {
-                g.applyConstraints(15, 50);
-            } else if (patternName == "Pattern3_Inverse_LowDensity") {
-                g.applyConstraints(5, 30);
-            } else if (patternName == "Pattern4_Inverse_HighDensity") {
-                g.applyConstraints(15, 50);
-            }
-            
             g.printStats();
-            graphs.push_back(g);
+            graphs.push_back(std::move(g));
         }
         
         return graphs;
     }
     
+    // Характеристики графа номер replicate серии seed в одном потоке; граф
+    // полностью определяется (seed, replicate) и сразу освобождается. Если
+    // задан savePath, граф перед этим записывается в файл (см. Graph::save);
+    // weighted - считать и взвешенные характеристики (см. Graph::measure)
+    static Graph::Measures sample(const PatternSpec& spec, int numPoints, std::uint64_t seed,
+                                  std::uint64_t replicate, double& a, double& b,
+                                  const std::string& savePath = "", bool weighted = false) {
+        SplitMix64 rng(seed, replicate);
+        Graph g = generateGraph(spec, numPoints, rng, rng(), 1, a, b);
+        if (!savePath.empty() && !g.save(savePath)) {
+            std::cerr << "Не удалось записать граф в файл " + savePath + "\n";
+        }
+        return g.measure(1, weighted);
+    }
+    
+    // Серия из replicates графов паттерна на всех ядрах. Каждый граф строится,
+    // измеряется и сразу освобождается; в памяти остаются только его
+    // характеристики. Граф номер r полностью определяется (seed, r), а
+    // характеристики суммируются в порядке номеров, поэтому итоги не зависят
+    // от числа потоков. Если perGraph задан, характеристики каждого
+    // графа пишутся в него строкой CSV (порядок строк произвольный). Если
+    // задан saveDir, каждый граф записывается в saveDir/<паттерн>_<r>.<format>.
+    // При weighted в итоги и CSV добавляются взвешенный диаметр и MST.
+    static EnsembleSummary runEnsemble(const PatternSpec& spec, int numPoints, int replicates,
+                                       std::uint64_t seed, int threads = 0,
+                                       std::ostream* perGraph = nullptr,
+                                       const std::string& saveDir = "",
+                                       const std::string& format = "csr",
+                                       bool weighted = false) {
+        if (threads <= 0) threads = defaultThreadCount();
+        std::vector<Graph::Measures> measures(replicates);
+        std::mutex outputMutex;
+        
+        parallelFor(replicates, threads, 1, [&](int begin, int end, int) {
+            for (int r = begin; r < end; ++r) {
+                double a, b;
+                std::string savePath;
+                if (!saveDir.empty()) {
+                    savePath = saveDir + "/" + spec.name + "_" + std::to_string(r) + "." + format;
+                }
+                measures[r] = sample(spec, numPoints, seed, r, a, b, savePath, weighted);
+                const Graph::Measures& m = measures[r];
+                
+                if (perGraph) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    *perGraph << spec.name << ',' << r << ',' << a << ',' << b << ','
+                              << m.diameter << ',' << m.edges << ',' << m.meanDegree << ','
+                              << m.maxDegree << ',' << m.minDegree << ','
+                              << m.components << ',' << m.largestComponent << ','
+                              << m.susceptibility;
+                    if (weighted) {
+                        *perGraph << ',' << m.weightedDiameter << ',' << m.mstWeight << ','
+                                  << m.mstDepth;
+                    }
+                    *perGraph << '\n';
+                }
+            }
+        });
+        
+        EnsembleSummary summary;
+        for (const auto& m : measures) summary.add(m, numPoints);
+        return summary;
+    }
+    
 void visualizeAllPatterns(const std::vector<std::vector<Graph>>& allGraphs) {
     std::vector<std::string> patternNames = {
         "Exp_LowDensity",
@@ -294,12 +881,35 @@ void visualizeAllPatterns(const std::vector<std::vector<Graph>>& allGraphs) {
     // Создаем папку для графиков
     system("mkdir -p graphs");
     
+    // Изображения строятся параллельно, по одному графу на поток
+    struct Job {
+        const Graph* graph;
+        std::string title, filename;
+        bool saved;
+    };
+    std::vector<Job> jobs;
     for (size_t p = 0; p < allGraphs.size(); ++p) {
-        std::cout << "\n=== Визуализация паттерна: " << patternNames[p] << " ===" << std::endl;
         for (size_t g = 0; g < allGraphs[p].size(); ++g) {
             std::string filename = "graphs/" + patternNames[p] + "_graph_" + std::to_string(g+1) + ".png";
             std::string title = patternNames[p] + " - Graph " + std::to_string(g+1);
-            allGraphs[p][g].visualize(title, filename);
+            jobs.push_back({&allGraphs[p][g], title, filename, false});
+        }
+    }
+    parallelFor((int)jobs.size(), defaultThreadCount(), 1, [&](int begin, int end, int) {
+        for (int j = begin; j < end; ++j) {
+            jobs[j].saved = jobs[j].graph->saveImage(jobs[j].title, jobs[j].filename, 1);
+        }
+    });
+    
+    size_t job = 0;
+    for (size_t p = 0; p < allGraphs.size(); ++p) {
+        std::cout << "\n=== Визуализация паттерна: " << patternNames[p] << " ===" << std::endl;
+        for (size_t g = 0; g < allGraphs[p].size(); ++g, ++job) {
+            if (jobs[job].saved) {
+                std::cout << "Граф сохранен в файл: " << jobs[job].filename << std::endl;
+            } else {
+                std::cerr << "Не удалось сохранить граф в файл: " << jobs[job].filename << std::endl;
+            }
         }
     }
     
@@ -307,7 +917,618 @@ void visualizeAllPatterns(const std::vector<std::vector<Graph>>& allGraphs) {
 }
 };
 
-int main() {
+// Точка перебора параметров модели
+struct SweepPoint {
+    double a, b;
+    std::string probType;
+    int numPoints;
+};
+
+// Настройки перебора: число повторов на точку, критерий остановки и уточнение сетки
+struct SweepSettings {
+    int minReplicates = 64;      // первый проход по каждой точке
+    int maxReplicates = 10000;   // предел повторов на точку
+    int batch = 16;              // повторов в одной задаче пула
+    double tolerance = 0.02;     // допустимая полуширина 95% ДИ (доля среднего)
+    int maxDegree = -1;          // ограничения, как в паттернах
+    double maxDistance = -1;
+    int refineRounds = 0;        // число уточнений сетки
+    double refineDelta = 0.1;    // скачок доли наибольшей компоненты для уточнения
+    std::uint64_t seed = 1;
+    int threads = 0;
+};
+
+struct SweepResult {
+    SweepPoint point;
+    EnsembleSummary summary;
+    bool converged;
+};
+
+// Перебор (a, b, probType, n) с повторами на пуле с перехватом задач.
+// Повторы точки идут раундами: первый - minReplicates графов, каждый
+// следующий удваивает их число, пока доверительные интервалы средней
+// степени, диаметра и доли наибольшей компоненты шире tolerance. Сошедшиеся
+// точки выбывают и освобождают ядра для остальных. После сходимости сетка
+// уточняется: между соседними по a или b точками со скачком доли наибольшей
+// компоненты больше refineDelta добавляется середина.
+// Граф повтора r точки определяется (seed, параметры точки, r), а пакеты
+// объединяются в порядке номеров, поэтому итоги не зависят от числа потоков.
+class ParameterSweep {
+private:
+    static std::uint64_t pointSeed(const SweepPoint& p, std::uint64_t seed) {
+        std::uint64_t bits[2];
+        std::memcpy(&bits[0], &p.a, sizeof(double));
+        std::memcpy(&bits[1], &p.b, sizeof(double));
+        SplitMix64 rng(seed ^ bits[0], bits[1] ^ ((std::uint64_t)p.numPoints << 1) ^ (p.probType == "exp"));
+        return rng();
+    }
+    
+    static bool converged(const EnsembleSummary& s, double tolerance) {
+        auto narrow = [&](const RunningStats& st, double floor) {
+            return st.confidenceHalfWidth() <= std::max(tolerance * std::abs(st.mean()), floor);
+        };
+        return narrow(s.meanDegree, 0) && narrow(s.diameter, 0) && narrow(s.giantFraction, tolerance);
+    }
+    
+    // Доведение точек active до сходимости или предела повторов
+    static void runPoints(WorkStealingPool& pool, std::vector<SweepResult>& results,
+                          std::vector<int> active, const SweepSettings& settings) {
+        std::vector<int> done(results.size(), 0);
+        for (int i : active) done[i] = (int)results[i].summary.meanDegree.count();
+        
+        while (!active.empty()) {
+            // Пакеты раунда: по одному слоту на пакет, объединяются по порядку
+            std::vector<std::vector<EnsembleSummary>> batches(active.size());
+            std::vector<int> target(active.size());
+            for (size_t k = 0; k < active.size(); ++k) {
+                int i = active[k];
+                target[k] = done[i] == 0 ? settings.minReplicates
+                                         : std::min(settings.maxReplicates, 2 * done[i]);
+                int count = target[k] - done[i];
+                batches[k].resize((count + settings.batch - 1) / settings.batch);
+                
+                PatternSpec spec{"", results[i].point.a, results[i].point.a,
+                                 results[i].point.b, results[i].point.b,
+                                 results[i].point.probType, settings.maxDegree, settings.maxDistance};
+                std::uint64_t seed = pointSeed(results[i].point, settings.seed);
+                int numPoints = results[i].point.numPoints;
+                for (size_t j = 0; j < batches[k].size(); ++j) {
+                    int first = done[i] + (int)j * settings.batch;
+                    int last = std::min(target[k], first + settings.batch);
+                    EnsembleSummary* slot = &batches[k][j];
+                    pool.submit([=](int) {
+                        for (int r = first; r < last; ++r) {
+                            double a, b;
+                            slot->add(GraphGenerator::sample(spec, numPoints, seed, r, a, b), numPoints);
+                        }
+                    });
+                }
+            }
+            pool.wait();
+            
+            std::vector<int> next;
+            for (size_t k = 0; k < active.size(); ++k) {
+                int i = active[k];
+                for (const auto& part : batches[k]) results[i].summary.merge(part);
+                done[i] = target[k];
+                results[i].converged = converged(results[i].summary, settings.tolerance);
+                if (!results[i].converged && done[i] < settings.maxReplicates) next.push_back(i);
+            }
+            active.swap(next);
+        }
+    }
+    
+    // Середины между соседними точками со скачком доли наибольшей компоненты
+    static std::vector<SweepPoint> refinePoints(const std::vector<SweepResult>& results,
+                                                double delta) {
+        std::vector<SweepPoint> added;
+        for (int axis = 0; axis < 2; ++axis) {
+            // Вдоль a точки группируются по (probType, n, b), вдоль b - по (probType, n, a)
+            auto fixed = [&](const SweepPoint& p) { return axis == 0 ? p.b : p.a; };
+            auto moving = [&](const SweepPoint& p) { return axis == 0 ? p.a : p.b; };
+            std::vector<int> order(results.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = (int)i;
+            std::sort(order.begin(), order.end(), [&](int x, int y) {
+                const SweepPoint& p = results[x].point;
+                const SweepPoint& q = results[y].point;
+                return std::make_tuple(p.probType, p.numPoints, fixed(p), moving(p)) <
+                       std::make_tuple(q.probType, q.numPoints, fixed(q), moving(q));
+            });
+            for (size_t k = 1; k < order.size(); ++k) {
+                const SweepResult& lo = results[order[k - 1]];
+                const SweepResult& hi = results[order[k]];
+                if (lo.point.probType != hi.point.probType || lo.point.numPoints != hi.point.numPoints ||
+                    fixed(lo.point) != fixed(hi.point)) continue;
+                double jump = std::abs(hi.summary.giantFraction.mean() - lo.summary.giantFraction.mean());
+                if (jump <= delta) continue;
+                SweepPoint mid = lo.point;
+                (axis == 0 ? mid.a : mid.b) = (moving(lo.point) + moving(hi.point)) / 2;
+                if (moving(mid) == moving(lo.point) || moving(mid) == moving(hi.point)) continue;
+                // Середина могла уже появиться при уточнении по другой оси
+                bool known = std::any_of(added.begin(), added.end(), [&](const SweepPoint& p) {
+                    return p.a == mid.a && p.b == mid.b && p.probType == mid.probType &&
+                           p.numPoints == mid.numPoints;
+                });
+                if (!known) added.push_back(mid);
+            }
+        }
+        return added;
+    }
+    
+public:
+    static std::vector<SweepResult> run(const std::vector<SweepPoint>& points,
+                                        const SweepSettings& settings) {
+        WorkStealingPool pool(settings.threads);
+        std::vector<SweepResult> results;
+        std::vector<int> active;
+        for (const auto& p : points) {
+            active.push_back((int)results.size());
+            results.push_back({p, EnsembleSummary(), false});
+        }
+        
+        for (int round = 0; ; ++round) {
+            runPoints(pool, results, active, settings);
+            if (round == settings.refineRounds) break;
+            
+            active.clear();
+            for (const auto& p : refinePoints(results, settings.refineDelta)) {
+                active.push_back((int)results.size());
+                results.push_back({p, EnsembleSummary(), false});
+            }
+            if (active.empty()) break;
+        }
+        
+        std::sort(results.begin(), results.end(), [](const SweepResult& x, const SweepResult& y) {
+            return std::make_tuple(x.point.probType, x.point.numPoints, x.point.a, x.point.b) <
+                   std::make_tuple(y.point.probType, y.point.numPoints, y.point.a, y.point.b);
+        });
+        return results;
+    }
+    
+    // Итоги в CSV: по строке на точку, среднее и полуширина ДИ каждой величины
+    static void write(std::ostream& out, const std::vector<SweepResult>& results) {
+        out << "prob,n,a,b,replicates,converged,mean_degree,mean_degree_ci,diameter,diameter_ci,"
+               "components,components_ci,giant_fraction,giant_fraction_ci,"
+               "susceptibility,susceptibility_ci\n";
+        for (const auto& r : results) {
+            const EnsembleSummary& s = r.summary;
+            out << r.point.probType << ',' << r.point.numPoints << ',' << r.point.a << ','
+                << r.point.b << ',' << s.meanDegree.count() << ',' << r.converged;
+            for (const RunningStats* st : {&s.meanDegree, &s.diameter, &s.components,
+                                           &s.giantFraction, &s.susceptibility}) {
+                out << ',' << st->mean() << ',' << st->confidenceHalfWidth();
+            }
+            out << '\n';
+        }
+    }
+    
+    // Оценки порога перколяции вдоль каждой линии сетки (по a при
+    // фиксированных probType, n, b и по b при фиксированном a): значение, где
+    // доля наибольшей компоненты пересекает 1/2 (линейная интерполяция между
+    // соседними точками), и точка пика восприимчивости
+    static void writeThresholds(std::ostream& out, const std::vector<SweepResult>& results) {
+        out << "prob,n,axis,fixed,giant_half,susceptibility_peak,susceptibility_max\n";
+        for (int axis = 0; axis < 2; ++axis) {
+            auto fixed = [&](const SweepPoint& p) { return axis == 0 ? p.b : p.a; };
+            auto moving = [&](const SweepPoint& p) { return axis == 0 ? p.a : p.b; };
+            std::vector<const SweepResult*> order;
+            for (const auto& r : results) order.push_back(&r);
+            std::sort(order.begin(), order.end(), [&](const SweepResult* x, const SweepResult* y) {
+                return std::make_tuple(x->point.probType, x->point.numPoints, fixed(x->point), moving(x->point)) <
+                       std::make_tuple(y->point.probType, y->point.numPoints, fixed(y->point), moving(y->point));
+            });
+            
+            for (size_t first = 0; first < order.size();) {
+                const SweepPoint& head = order[first]->point;
+                size_t last = first;
+                while (last < order.size() && order[last]->point.probType == head.probType &&
+                       order[last]->point.numPoints == head.numPoints &&
+                       fixed(order[last]->point) == fixed(head)) ++last;
+                
+                if (last - first >= 2) {
+                    double crossing = std::numeric_limits<double>::quiet_NaN();
+                    for (size_t k = first + 1; k < last && std::isnan(crossing); ++k) {
+                        double g0 = order[k - 1]->summary.giantFraction.mean() - 0.5;
+                        double g1 = order[k]->summary.giantFraction.mean() - 0.5;
+                        if (g0 == 0) crossing = moving(order[k - 1]->point);
+                        else if (g0 * g1 < 0 || g1 == 0) {
+                            double x0 = moving(order[k - 1]->point), x1 = moving(order[k]->point);
+                            crossing = x0 + (x1 - x0) * g0 / (g0 - g1);
+                        }
+                    }
+                    const SweepResult* peak = order[first];
+                    for (size_t k = first; k < last; ++k) {
+                        if (order[k]->summary.susceptibility.mean() > peak->summary.susceptibility.mean()) {
+                            peak = order[k];
+                        }
+                    }
+                    out << head.probType << ',' << head.numPoints << ',' << (axis == 0 ? 'a' : 'b') << ','
+                        << fixed(head) << ',';
+                    if (!std::isnan(crossing)) out << crossing;
+                    out << ',' << moving(peak->point) << ',' << peak->summary.susceptibility.mean() << '\n';
+                }
+                first = last;
+            }
+        }
+    }
+};
+
+// Режим серий: main --ensemble N [--points n] [--threads t] [--seed s] [--output file]
+//   [--save dir] [--format csr|edges|edges.gz|graphml|dot] [--weighted]
+// Для каждого паттерна строится N графов, выводятся только итоговые оценки;
+// характеристики отдельных графов при --output пишутся в CSV, сами графы
+// при --save - в отдельные файлы каталога dir. --weighted добавляет
+// взвешенный диаметр и MST (заметно дороже остальных характеристик)
+int runEnsembleMode(int argc, char* argv[]) {
+    int replicates = 0;
+    int numPoints = 100;
+    int threads = 0;
+    bool weighted = false;
+    std::uint64_t seed = std::random_device()();
+    std::string output, saveDir, format = "csr";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--weighted") {
+            weighted = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Не задано значение параметра " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--ensemble") replicates = std::stoi(value);
+            else if (arg == "--points") numPoints = std::stoi(value);
+            else if (arg == "--threads") threads = std::stoi(value);
+            else if (arg == "--seed") seed = std::stoull(value);
+            else if (arg == "--output") output = value;
+            else if (arg == "--save") saveDir = value;
+            else if (arg == "--format") format = value;
+            else {
+                std::cerr << "Неизвестный параметр " << arg << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Неверное значение параметра " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+    
+    std::ofstream csv;
+    if (!output.empty()) {
+        csv.open(output);
+        if (!csv) {
+            std::cerr << "Не удалось открыть файл " << output << std::endl;
+            return 1;
+        }
+        csv << "pattern,replicate,a,b,diameter,edges,mean_degree,max_degree,min_degree,"
+               "components,largest_component,susceptibility";
+        if (weighted) csv << ",weighted_diameter,mst_weight,mst_depth";
+        csv << '\n';
+    }
+    
+    if (!saveDir.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(saveDir, error);
+        if (error) {
+            std::cerr << "Не удалось создать каталог " << saveDir << std::endl;
+            return 1;
+        }
+    }
+    
+    std::vector<PatternSpec> patterns = {
+        GraphGenerator::makePattern("Pattern1_Exp_LowDensity", {0.01, 0.05}, {1.0, 2.0}, "exp"),
+        GraphGenerator::makePattern("Pattern2_Exp_HighDensity", {0.1, 0.5}, {2.0, 3.0}, "exp"),
+        GraphGenerator::makePattern("Pattern3_Inverse_LowDensity", {0.01, 0.05}, {2.0, 3.0}, "inv"),
+        GraphGenerator::makePattern("Pattern4_Inverse_HighDensity", {0.1, 0.5}, {1.0, 2.0}, "inv"),
+    };
+    
+    std::cout << "Серии по " << replicates << " графов из " << numPoints
+              << " вершин, seed = " << seed << std::endl;
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        // У каждого паттерна своя последовательность графов
+        EnsembleSummary summary = GraphGenerator::runEnsemble(
+            patterns[p], numPoints, replicates, SplitMix64(seed, p)(), threads,
+            csv.is_open() ? &csv : nullptr, saveDir, format, weighted);
+        std::cout << "\n=== Паттерн: " << patterns[p].name << " ===" << std::endl;
+        summary.print();
+    }
+    return 0;
+}
+
+// Значения параметра: "от:до:количество" - равномерная сетка, иначе список через запятую
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::string item;
+    std::istringstream in(text);
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+std::vector<double> parseValues(const std::string& text) {
+    std::vector<double> values;
+    size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        size_t second = text.find(':', colon + 1);
+        double from = std::stod(text.substr(0, colon));
+        double to = std::stod(text.substr(colon + 1, second - colon - 1));
+        int count = second == std::string::npos ? 2 : std::stoi(text.substr(second + 1));
+        for (int i = 0; i < count; ++i) {
+            values.push_back(count == 1 ? from : from + (to - from) * i / (count - 1));
+        }
+        return values;
+    }
+    for (const auto& item : splitList(text)) values.push_back(std::stod(item));
+    return values;
+}
+
+// Режим перебора: main --sweep --a от:до:к --b от:до:к [--prob exp,inv] [--points n1,n2]
+//   [--min r] [--max r] [--batch r] [--tol e] [--refine k] [--refine-delta d]
+//   [--max-degree d] [--max-distance r] [--threads t] [--seed s] [--output file]
+//   [--thresholds file]
+// Оценки порогов перколяции пишутся в файл --thresholds или в stderr
+int runSweepMode(int argc, char* argv[]) {
+    std::vector<double> aValues, bValues;
+    std::vector<std::string> probTypes = {"exp", "inv"};
+    std::vector<double> sizes = {100};
+    SweepSettings settings;
+    settings.seed = std::random_device()();
+    std::string output, thresholds;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Не задано значение параметра " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--a") aValues = parseValues(value);
+            else if (arg == "--b") bValues = parseValues(value);
+            else if (arg == "--prob") probTypes = splitList(value);
+            else if (arg == "--points") sizes = parseValues(value);
+            else if (arg == "--min") settings.minReplicates = std::stoi(value);
+            else if (arg == "--max") settings.maxReplicates = std::stoi(value);
+            else if (arg == "--batch") settings.batch = std::max(1, std::stoi(value));
+            else if (arg == "--tol") settings.tolerance = std::stod(value);
+            else if (arg == "--refine") settings.refineRounds = std::stoi(value);
+            else if (arg == "--refine-delta") settings.refineDelta = std::stod(value);
+            else if (arg == "--max-degree") settings.maxDegree = std::stoi(value);
+            else if (arg == "--max-distance") settings.maxDistance = std::stod(value);
+            else if (arg == "--threads") settings.threads = std::stoi(value);
+            else if (arg == "--seed") settings.seed = std::stoull(value);
+            else if (arg == "--output") output = value;
+            else if (arg == "--thresholds") thresholds = value;
+            else {
+                std::cerr << "Неизвестный параметр " << arg << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Неверное значение параметра " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+    if (aValues.empty() || bValues.empty()) {
+        std::cerr << "Нужно задать значения --a и --b" << std::endl;
+        return 1;
+    }
+    
+    std::vector<SweepPoint> points;
+    for (const auto& probType : probTypes) {
+        for (double n : sizes) {
+            for (double a : aValues) {
+                for (double b : bValues) {
+                    points.push_back({a, b, probType, (int)n});
+                }
+            }
+        }
+    }
+    
+    std::cerr << "Перебор " << points.size() << " точек, seed = " << settings.seed << std::endl;
+    std::vector<SweepResult> results = ParameterSweep::run(points, settings);
+    
+    if (output.empty()) {
+        ParameterSweep::write(std::cout, results);
+    } else {
+        std::ofstream out(output);
+        if (!out) {
+            std::cerr << "Не удалось открыть файл " << output << std::endl;
+            return 1;
+        }
+        ParameterSweep::write(out, results);
+    }
+    
+    if (thresholds.empty()) {
+        ParameterSweep::writeThresholds(std::cerr, results);
+    } else {
+        std::ofstream out(thresholds);
+        if (!out) {
+            std::cerr << "Не удалось открыть файл " << thresholds << std::endl;
+            return 1;
+        }
+        ParameterSweep::writeThresholds(out, results);
+    }
+    return 0;
+}
+
+// Граф из numPoints равномерно распределенных точек без ребер. Ребра
+// строятся от отдельного зерна rng(), как в GraphGenerator::sample: поток
+// точек не должен совпадать с потоками ячеек в generateEdges
+Graph randomPointGraph(int numPoints, SplitMix64& rng) {
+    Graph g(numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        double x = rng.uniform() * 100;
+        g.addPoint(Point(x, rng.uniform() * 100));
+    }
+    return g;
+}
+
+// Режим генерации одного графа в файл: main --generate --a a --b b --output file
+//   [--prob exp|inv] [--points n] [--max-distance r] [--min-probability p]
+//   [--seed s] [--threads t]
+// Точки равномерны в квадрате 100 x 100. Списки ребер, GraphML и DOT пишутся
+// прямо из генератора без построения графа в памяти; для .csr граф строится
+// и записывается целиком.
+int runGenerateMode(int argc, char* argv[]) {
+    double a = -1, b = -1, maxDistance = -1, minProbability = 0;
+    std::string probType = "exp", output;
+    int numPoints = 100, threads = 0;
+    std::uint64_t seed = std::random_device()();
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Не задано значение параметра " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--a") a = std::stod(value);
+            else if (arg == "--b") b = std::stod(value);
+            else if (arg == "--prob") probType = value;
+            else if (arg == "--points") numPoints = std::stoi(value);
+            else if (arg == "--max-distance") maxDistance = std::stod(value);
+            else if (arg == "--min-probability") minProbability = std::stod(value);
+            else if (arg == "--seed") seed = std::stoull(value);
+            else if (arg == "--threads") threads = std::stoi(value);
+            else if (arg == "--output") output = value;
+            else {
+                std::cerr << "Неизвестный параметр " << arg << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Неверное значение параметра " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+    if (a < 0 || b < 0 || output.empty()) {
+        std::cerr << "Нужно задать --a, --b и --output" << std::endl;
+        return 1;
+    }
+    
+    SplitMix64 rng(seed, 0);
+    Graph g = randomPointGraph(numPoints, rng);
+    std::uint64_t edgeSeed = rng();
+    
+    bool saved;
+    if (hasSuffix(output, ".csr")) {
+        g.setEdgeAttributes(true, true);
+        g.buildGraph(a, b, probType, maxDistance, minProbability, edgeSeed, threads);
+        saved = g.save(output);
+        if (saved && !g.matches(MappedCSR(output))) {
+            std::cerr << "Файл " << output << " не совпадает с построенным графом" << std::endl;
+            return 1;
+        }
+    } else {
+        std::unique_ptr<GraphWriter> writer = makeGraphWriter(output);
+        saved = writer && g.streamGraph(*writer, a, b, probType, maxDistance, minProbability, edgeSeed, threads);
+    }
+    if (!saved) {
+        std::cerr << "Не удалось записать граф в файл " << output << std::endl;
+        return 1;
+    }
+    std::cout << "Граф сохранен в файл: " << output << std::endl;
+    return 0;
+}
+
+// Режим --distances: приближенные диаметр и распределение расстояний
+// одного графа. Параметры графа - как в --generate; --method sample|hyperanf,
+// --error, --confidence (для выборки), --memory (МБ, для HyperANF),
+// --output - CSV функции окрестностей
+int runDistancesMode(int argc, char* argv[]) {
+    double a = -1, b = -1, maxDistance = -1, minProbability = 0;
+    double error = 0.05, confidence = 0.95;
+    size_t memoryMB = 1024;
+    std::string probType = "exp", method = "sample", output;
+    int numPoints = 100, threads = 0;
+    std::uint64_t seed = std::random_device()();
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Не задано значение параметра " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--a") a = std::stod(value);
+            else if (arg == "--b") b = std::stod(value);
+            else if (arg == "--prob") probType = value;
+            else if (arg == "--points") numPoints = std::stoi(value);
+            else if (arg == "--max-distance") maxDistance = std::stod(value);
+            else if (arg == "--min-probability") minProbability = std::stod(value);
+            else if (arg == "--seed") seed = std::stoull(value);
+            else if (arg == "--threads") threads = std::stoi(value);
+            else if (arg == "--method") method = value;
+            else if (arg == "--error") error = std::stod(value);
+            else if (arg == "--confidence") confidence = std::stod(value);
+            else if (arg == "--memory") memoryMB = std::stoull(value);
+            else if (arg == "--output") output = value;
+            else {
+                std::cerr << "Неизвестный параметр " << arg << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Неверное значение параметра " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+    if (a < 0 || b < 0) {
+        std::cerr << "Нужно задать --a и --b" << std::endl;
+        return 1;
+    }
+    if (method != "sample" && method != "hyperanf") {
+        std::cerr << "Неизвестный метод " << method << " (sample или hyperanf)" << std::endl;
+        return 1;
+    }
+    if (error <= 0 || error >= 1 || confidence <= 0 || confidence >= 1) {
+        std::cerr << "--error и --confidence должны быть в (0, 1)" << std::endl;
+        return 1;
+    }
+    
+    SplitMix64 rng(seed, 0);
+    Graph g = randomPointGraph(numPoints, rng);
+    g.buildGraph(a, b, probType, maxDistance, minProbability, rng(), threads);
+    Graph::DistanceEstimate estimate = g.estimateDistances(
+        method == "sample" ? Graph::DistanceMethod::Sampling : Graph::DistanceMethod::HyperANF,
+        error, confidence, memoryMB << 20, seed, threads);
+    const DistanceDistribution& distribution = estimate.distribution;
+    
+    std::cout << "Ребер: " << g.csr().numEdges() << std::endl;
+    std::cout << "Диаметр: от " << estimate.bounds.lower << " до " << estimate.bounds.upper << std::endl;
+    std::cout << "Эффективный диаметр (90%): " << distribution.effectiveDiameter() << std::endl;
+    std::cout << "Среднее расстояние: " << distribution.averageDistance() << std::endl;
+    std::cout << "Точность оценки: " << distribution.error << std::endl;
+    
+    if (!output.empty()) {
+        std::ofstream csv(output);
+        if (!csv) {
+            std::cerr << "Не удалось открыть файл " << output << std::endl;
+            return 1;
+        }
+        csv << "distance,pairs,fraction\n";
+        for (size_t t = 0; t < distribution.within.size(); ++t) {
+            csv << t << ',' << distribution.within[t] << ','
+                << distribution.within[t] / distribution.within.back() << '\n';
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        return runSweepMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--generate") {
+        return runGenerateMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--distances") {
+        return runDistancesMode(argc, argv);
+    }
+    if (argc > 1) {
+        return runEnsembleMode(argc, argv);
+    }
+    
     GraphGenerator generator;
     std::vector<std::vector<Graph>> allGraphs;
     
@@ -317,7 +1538,7 @@ int main() {
         {0.01, 0.05}, {1.0, 2.0},
         "exp", 100, 5
     );
-    allGraphs.push_back(pattern1);
+    allGraphs.push_back(std::move(pattern1));
     
     // Паттерн 2: Экспоненциальная вероятность, высокая плотность (большие a и b)
     auto pattern2 = generator.generatePattern(
@@ -325,7 +1546,7 @@ int main() {
         {0.1, 0.5}, {2.0, 3.0},
         "exp", 100, 5
     );
-    allGraphs.push_back(pattern2);
+    allGraphs.push_back(std::move(pattern2));
     
     // Паттерн 3: Обратная степенная, низкая плотность
     auto pattern3 = generator.generatePattern(
@@ -333,7 +1554,7 @@ int main() {
         {0.01, 0.05}, {2.0, 3.0},
         "inv", 100, 5
     );
-    allGraphs.push_back(pattern3);
+    allGraphs.push_back(std::move(pattern3));
     
     // Паттерн 4: Обратная степенная, высокая плотность
     auto pattern4 = generator.generatePattern(
@@ -341,7 +1562,7 @@ int main() {
         {0.1, 0.5}, {1.0, 2.0},
         "inv", 100, 5
     );
-    allGraphs.push_back(pattern4);
+    allGraphs.push_back(std::move(pattern4));
     
     std::cout << "\n=== Статистика по всем паттернам ===" << std::endl;
     for (size_t p = 0; p < allGraphs.size(); ++p) {
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Число потоков по умолчанию - число аппаратных потоков
+inline int defaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Параллельный цикл по [0, n): потоки забирают блоки по chunk индексов
+// из общего счетчика. func(begin, end, thread) вызывается для каждого блока.
+template <typename Func>
+void parallelFor(int n, int threads, int chunk, Func func) {
+    threads = std::max(1, std::min(threads, (n + chunk - 1) / chunk));
+    if (threads == 1) {
+        if (n > 0) func(0, n, 0);
+        return;
+    }
+    
+    std::atomic<int> next(0);
+    auto worker = [&](int thread) {
+        for (;;) {
+            int begin = next.fetch_add(chunk);
+            if (begin >= n) break;
+            func(begin, std::min(n, begin + chunk), thread);
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+}
+
+// Пул потоков с собственной очередью задач у каждого потока. Поток берет
+// задачи из конца своей очереди, а оставшись без работы, крадет из начала
+// чужих - так задачи разной длины сами распределяются по ядрам. Задача
+// получает номер исполняющего потока и может добавлять новые задачи.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(int)>;
+    
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex stateMutex;
+    std::condition_variable wakeup;       // появились задачи или пул остановлен
+    std::condition_variable idle;         // все задачи выполнены
+    std::atomic<long long> queued{0};     // задачи в очередях
+    std::atomic<long long> pending{0};    // добавленные и не завершенные задачи
+    std::atomic<unsigned> nextQueue{0};
+    bool stopping = false;
+    
+    bool pop(int thread, Task& task) {
+        {
+            Queue& own = *queues[thread];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --queued;
+                return true;
+            }
+        }
+        int n = (int)queues.size();
+        for (int k = 1; k < n; ++k) {
+            Queue& other = *queues[(thread + k) % n];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.tasks.empty()) {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                --queued;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void workerLoop(int thread) {
+        Task task;
+        for (;;) {
+            if (pop(thread, task)) {
+                task(thread);
+                task = nullptr;
+                if (--pending == 0) {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    idle.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wakeup.wait(lock, [&] { return stopping || queued > 0; });
+            if (stopping && queued == 0) return;
+        }
+    }
+    
+public:
+    explicit WorkStealingPool(int threads = 0) {
+        if (threads <= 0) threads = defaultThreadCount();
+        for (int t = 0; t < threads; ++t) queues.push_back(std::make_unique<Queue>());
+        for (int t = 0; t < threads; ++t) workers.emplace_back([this, t] { workerLoop(t); });
+    }
+    
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto& th : workers) th.join();
+    }
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    int size() const { return (int)queues.size(); }
+    
+    // Добавление задачи: из задачи пула (thread - ее номер потока) - в свою
+    // очередь, извне (thread = -1) - в очереди потоков по кругу
+    void submit(Task task, int thread = -1) {
+        if (thread < 0) thread = nextQueue++ % queues.size();
+        ++pending;
+        {
+            Queue& queue = *queues[thread];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+            ++queued;
+        }
+        std::lock_guard<std::mutex> lock(stateMutex);
+        wakeup.notify_one();
+    }
+    
+    // Ожидание завершения всех задач, включая добавленные во время ожидания
+    void wait() {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        idle.wait(lock, [&] { return pending == 0; });
+    }
+};
+
+// Быстрый генератор SplitMix64. Состояние - одно 64-битное число, поэтому
+// независимый поток можно завести на каждую ячейку или задачу: результат
+// не зависит от числа потоков и порядка обработки.
+class SplitMix64 {
+private:
+    std::uint64_t state;
+    
+public:
+    using result_type = std::uint64_t;
+    
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+    
+    // Генератор для подпотока stream от общего зерна
+    SplitMix64(std::uint64_t seed, std::uint64_t stream)
+        : state(seed ^ (stream * 0xD1B54A32D192ED03ULL)) {
+        (*this)();
+    }
+    
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    
+    result_type operator()() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    
+    // Равномерное число в [0, 1)
+    double uniform() {
+        return ((*this)() >> 11) * 0x1.0p-53;
+    }
+};
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+#include "deflate.h"
+#include "geometry.h"
+#include "parallel.h"
+
+struct Color {
+    std::uint8_t r, g, b;
+};
+
+// Растровое RGB-изображение с рисованием сглаженных линий, кругов и текста.
+// Изображение может быть полосой строк [top, top + height) большего
+// изображения: координаты рисования остаются общими, а все, что вне полосы,
+// отсекается. Так потоки рисуют свои полосы независимо.
+class Raster {
+private:
+    int width, height;
+    int top;                             // номер первой строки полосы
+    std::vector<std::uint8_t> pixels;
+    
+    // Шрифт 5x8 для ASCII 32..126: пять столбцов на символ, младший бит - верхняя строка
+    static const std::uint8_t* glyph(char c) {
+        static const std::uint8_t font[95][5] = {
+            {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00},
+            {0x14,0x7F,0x14,0x7F,0x14}, {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62},
+            {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00}, {0x00,0x1C,0x22,0x41,0x00},
+            {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+            {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00},
+            {0x20,0x10,0x08,0x04,0x02}, {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00},
+            {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33}, {0x18,0x14,0x12,0x7F,0x10},
+            {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+            {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00},
+            {0x00,0x40,0x34,0x00,0x00}, {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14},
+            {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06}, {0x3E,0x41,0x5D,0x59,0x4E},
+            {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+            {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01},
+            {0x3E,0x41,0x41,0x51,0x73}, {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00},
+            {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, {0x7F,0x40,0x40,0x40,0x40},
+            {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+            {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46},
+            {0x26,0x49,0x49,0x49,0x32}, {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F},
+            {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, {0x63,0x14,0x08,0x14,0x63},
+            {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+            {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04},
+            {0x40,0x40,0x40,0x40,0x40}, {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40},
+            {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28}, {0x38,0x44,0x44,0x28,0x7F},
+            {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+            {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00},
+            {0x7F,0x10,0x28,0x44,0x00}, {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78},
+            {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, {0xFC,0x18,0x24,0x24,0x18},
+            {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+            {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C},
+            {0x3C,0x40,0x30,0x40,0x3C}, {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C},
+            {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00}, {0x00,0x00,0x77,0x00,0x00},
+            {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02},
+        };
+        if (c < 32 || c > 126) c = '?';
+        return font[c - 32];
+    }
+
+public:
+    Raster(int w, int h, Color background = {255, 255, 255}, int firstRow = 0)
+        : width(w), height(h), top(firstRow), pixels((size_t)w * h * 3) {
+        for (size_t i = 0; i < pixels.size(); i += 3) {
+            pixels[i] = background.r;
+            pixels[i + 1] = background.g;
+            pixels[i + 2] = background.b;
+        }
+    }
+    
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::uint8_t* row(int y) const { return pixels.data() + (size_t)(y - top) * width * 3; }
+    
+    // Перенос полосы band в это изображение
+    void copyBand(const Raster& band) {
+        int first = std::max(top, band.top);
+        int last = std::min(top + height, band.top + band.height);
+        for (int y = first; y < last; ++y) {
+            std::copy(band.row(y), band.row(y) + width * 3,
+                      pixels.begin() + (size_t)(y - top) * width * 3);
+        }
+    }
+    
+    // Смешивание пикселя с цветом c с непрозрачностью alpha из [0, 1]
+    void blend(int x, int y, Color c, double alpha) {
+        if (x < 0 || x >= width || y < top || y >= top + height || alpha <= 0) return;
+        alpha = std::min(alpha, 1.0);
+        std::uint8_t* p = pixels.data() + ((size_t)(y - top) * width + x) * 3;
+        p[0] = (std::uint8_t)std::lround(p[0] + (c.r - p[0]) * alpha);
+        p[1] = (std::uint8_t)std::lround(p[1] + (c.g - p[1]) * alpha);
+        p[2] = (std::uint8_t)std::lround(p[2] + (c.b - p[2]) * alpha);
+    }
+    
+    // Сглаженный отрезок толщины lineWidth: покрытие пикселя считается по
+    // расстоянию от его центра до отрезка. Обход идет вдоль главной оси,
+    // по второй оси - только пиксели в пределах толщины линии.
+    void drawLine(double x0, double y0, double x1, double y1, Color c, double lineWidth = 1.0) {
+        double dx = x1 - x0, dy = y1 - y0;
+        double length2 = dx * dx + dy * dy;
+        double reach = lineWidth / 2 + 0.5;
+        bool steep = std::abs(dy) > std::abs(dx);
+        
+        auto coverage = [&](int px, int py) {
+            double cx = px + 0.5 - x0, cy = py + 0.5 - y0;
+            double t = length2 > 0 ? std::clamp((cx * dx + cy * dy) / length2, 0.0, 1.0) : 0.0;
+            double ex = cx - t * dx, ey = cy - t * dy;
+            return lineWidth / 2 + 0.5 - std::sqrt(ex * ex + ey * ey);
+        };
+        
+        // Главная ось: u, вторая: v; линия v = v0 + slope * (u - u0)
+        double u0 = steep ? y0 : x0, u1 = steep ? y1 : x1;
+        double v0 = steep ? x0 : y0, v1 = steep ? x1 : y1;
+        if (u0 > u1) {
+            std::swap(u0, u1);
+            std::swap(v0, v1);
+        }
+        double slope = u1 > u0 ? (v1 - v0) / (u1 - u0) : 0;
+        double spread = reach * std::sqrt(1 + slope * slope);
+        
+        int uBegin = (int)std::floor(u0 - reach), uEnd = (int)std::ceil(u1 + reach);
+        if (steep) {
+            uBegin = std::max(uBegin, top);
+            uEnd = std::min(uEnd, top + height - 1);
+        } else {
+            uBegin = std::max(uBegin, 0);
+            uEnd = std::min(uEnd, width - 1);
+            // Только столбцы, где линия проходит через полосу
+            if (slope != 0) {
+                double ua = u0 + (top - spread - v0) / slope;
+                double ub = u0 + (top + height + spread - v0) / slope;
+                if (ua > ub) std::swap(ua, ub);
+                uBegin = std::max(uBegin, (int)std::floor(ua) - 1);
+                uEnd = std::min(uEnd, (int)std::ceil(ub) + 1);
+            }
+        }
+        for (int u = uBegin; u <= uEnd; ++u) {
+            double center = v0 + slope * (std::clamp(u + 0.5, u0, u1) - u0);
+            int vBegin = (int)std::floor(center - spread), vEnd = (int)std::ceil(center + spread);
+            for (int v = vBegin; v <= vEnd; ++v) {
+                int px = steep ? v : u, py = steep ? u : v;
+                blend(px, py, c, coverage(px, py));
+            }
+        }
+    }
+    
+    // Сглаженный круг (покрытие по расстоянию от центра пикселя до окружности)
+    void fillCircle(double cx, double cy, double radius, Color c) {
+        int yBegin = std::max(top, (int)std::floor(cy - radius - 1));
+        int yEnd = std::min(top + height - 1, (int)std::ceil(cy + radius + 1));
+        int xBegin = std::max(0, (int)std::floor(cx - radius - 1));
+        int xEnd = std::min(width - 1, (int)std::ceil(cx + radius + 1));
+        for (int y = yBegin; y <= yEnd; ++y) {
+            for (int x = xBegin; x <= xEnd; ++x) {
+                double d = std::hypot(x + 0.5 - cx, y + 0.5 - cy);
+                blend(x, y, c, radius + 0.5 - d);
+            }
+        }
+    }
+    
+    void fillRect(int x, int y, int w, int h, Color c) {
+        for (int py = y; py < y + h; ++py) {
+            for (int px = x; px < x + w; ++px) blend(px, py, c, 1);
+        }
+    }
+    
+    // Текст растровым шрифтом 5x8, scale - размер точки шрифта в пикселях
+    void drawText(int x, int y, const std::string& text, Color c, int scale = 1) {
+        for (char ch : text) {
+            const std::uint8_t* columns = glyph(ch);
+            for (int col = 0; col < 5; ++col) {
+                for (int bit = 0; bit < 8; ++bit) {
+                    if (columns[col] >> bit & 1) {
+                        fillRect(x + col * scale, y + bit * scale, scale, scale, c);
+                    }
+                }
+            }
+            x += 6 * scale;
+        }
+    }
+    
+    static int textWidth(const std::string& text, int scale = 1) {
+        return (int)text.size() * 6 * scale - scale;
+    }
+};
+
+// Запись изображения в PNG (RGB, 8 бит на канал) без внешних библиотек
+class PNGWriter {
+private:
+    static void chunk(std::ofstream& file, const char* type, const std::vector<std::uint8_t>& body) {
+        std::uint8_t header[8];
+        std::uint32_t size = (std::uint32_t)body.size();
+        for (int k = 0; k < 4; ++k) header[k] = size >> (24 - 8 * k) & 0xFF;
+        std::copy(type, type + 4, header + 4);
+        std::uint32_t crc = Deflate::crc32(header + 4, 4);
+        crc = Deflate::crc32(body.data(), body.size(), crc);
+        std::uint8_t trailer[4];
+        for (int k = 0; k < 4; ++k) trailer[k] = crc >> (24 - 8 * k) & 0xFF;
+        file.write(reinterpret_cast<const char*>(header), 8);
+        file.write(reinterpret_cast<const char*>(body.data()), body.size());
+        file.write(reinterpret_cast<const char*>(trailer), 4);
+    }
+
+public:
+    static bool write(const Raster& image, const std::string& filename) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file) return false;
+        
+        int w = image.getWidth(), h = image.getHeight();
+        static const std::uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        file.write(reinterpret_cast<const char*>(signature), 8);
+        
+        std::vector<std::uint8_t> header = {
+            std::uint8_t(w >> 24), std::uint8_t(w >> 16), std::uint8_t(w >> 8), std::uint8_t(w),
+            std::uint8_t(h >> 24), std::uint8_t(h >> 16), std::uint8_t(h >> 8), std::uint8_t(h),
+            8, 2, 0, 0, 0   // 8 бит, RGB, deflate, без фильтров, без чересстрочности
+        };
+        chunk(file, "IHDR", header);
+        
+        // Каждая строка начинается с байта фильтра (0 - без фильтра)
+        int stride = w * 3 + 1;
+        std::vector<std::uint8_t> raw((size_t)stride * h);
+        for (int y = 0; y < h; ++y) {
+            raw[(size_t)y * stride] = 0;
+            std::copy(image.row(y), image.row(y) + w * 3, raw.begin() + (size_t)y * stride + 1);
+        }
+        // Поток zlib: заголовок (deflate, окно 32 КБ), данные, Adler-32
+        std::vector<std::uint8_t> compressed = {0x78, 0x01};
+        std::vector<std::uint8_t> block = Deflate::compress(raw.data(), raw.size(), stride);
+        compressed.insert(compressed.end(), block.begin(), block.end());
+        std::uint32_t adler = Deflate::adler32(raw.data(), raw.size());
+        for (int shift = 24; shift >= 0; shift -= 8) compressed.push_back(adler >> shift & 0xFF);
+        chunk(file, "IDAT", compressed);
+        chunk(file, "IEND", {});
+        return (bool)file;
+    }
+};
+
+// Изображение графа на плоскости [0, extent] x [0, extent]: ребра, вершины,
+// рамка с подписями осей и заголовок. Формат выбирается по расширению файла:
+// .svg - векторный, иначе PNG.
+class GraphRenderer {
+private:
+    const std::vector<Point>& points;
+    const CSRGraph& graph;
+    double extent;
+    int size;            // сторона изображения в пикселях
+    int margin;          // поле под подписи осей и заголовок
+    
+    static constexpr Color EDGE_COLOR = {0, 0, 255};
+    static constexpr Color VERTEX_COLOR = {31, 119, 180};
+    static constexpr Color AXIS_COLOR = {0, 0, 0};
+    static constexpr double EDGE_WIDTH = 1.5;
+    static constexpr double VERTEX_RADIUS = 5;
+    
+    double toX(double x) const { return margin + x / extent * (size - 2 * margin); }
+    double toY(double y) const { return size - margin - y / extent * (size - 2 * margin); }
+    
+    // Рисование полосы строк [top, bottom): все объекты, задевающие полосу
+    void drawBand(Raster& image, int top, int bottom, const std::string& title) const {
+        double reach = EDGE_WIDTH / 2 + 1;
+        int n = (int)points.size();
+        for (int v = 0; v < n; ++v) {
+            double yv = toY(points[v].y);
+            for (const std::uint32_t* u = graph.begin(v); u != graph.end(v); ++u) {
+                if (v >= (int)*u) continue;
+                double yu = toY(points[*u].y);
+                if (std::max(yv, yu) + reach < top || std::min(yv, yu) - reach > bottom) continue;
+                image.drawLine(toX(points[v].x), yv, toX(points[*u].x), yu, EDGE_COLOR, EDGE_WIDTH);
+            }
+        }
+        for (const auto& p : points) {
+            double y = toY(p.y);
+            if (y + VERTEX_RADIUS + 1 < top || y - VERTEX_RADIUS - 1 > bottom) continue;
+            image.fillCircle(toX(p.x), y, VERTEX_RADIUS, VERTEX_COLOR);
+        }
+        
+        // Рамка, деления и подписи осей
+        int left = margin, right = size - margin, upper = margin, lower = size - margin;
+        image.fillRect(left, upper, right - left + 1, 1, AXIS_COLOR);
+        image.fillRect(left, lower, right - left + 1, 1, AXIS_COLOR);
+        image.fillRect(left, upper, 1, lower - upper + 1, AXIS_COLOR);
+        image.fillRect(right, upper, 1, lower - upper + 1, AXIS_COLOR);
+        for (int k = 0; k <= 5; ++k) {
+            double value = extent * k / 5;
+            std::string label = std::to_string((int)std::lround(value));
+            int x = (int)std::lround(toX(value)), y = (int)std::lround(toY(value));
+            image.fillRect(x, lower, 1, 6, AXIS_COLOR);
+            image.drawText(x - Raster::textWidth(label, 2) / 2, lower + 10, label, AXIS_COLOR, 2);
+            image.fillRect(left - 6, y, 6, 1, AXIS_COLOR);
+            image.drawText(left - 10 - Raster::textWidth(label, 2), y - 7, label, AXIS_COLOR, 2);
+        }
+        image.drawText((size - Raster::textWidth(title, 3)) / 2, margin / 2 - 12, title, AXIS_COLOR, 3);
+    }
+
+public:
+    GraphRenderer(const std::vector<Point>& pts, const CSRGraph& g, double ext = 100,
+                  int imageSize = 1000)
+        : points(pts), graph(g), extent(ext), size(imageSize), margin(imageSize / 12) {}
+    
+    // Растровое изображение; полосы строк рисуются параллельно
+    Raster render(const std::string& title, int threads = 0) const {
+        if (threads <= 0) threads = defaultThreadCount();
+        Raster image(size, size);
+        const int BAND = 64;
+        int bands = (size + BAND - 1) / BAND;
+        parallelFor(bands, threads, 1, [&](int begin, int end, int) {
+            for (int band = begin; band < end; ++band) {
+                int top = band * BAND, bottom = std::min(size, top + BAND);
+                Raster part(size, bottom - top, {255, 255, 255}, top);
+                drawBand(part, top, bottom, title);
+                image.copyBand(part);
+            }
+        });
+        return image;
+    }
+    
+    bool savePNG(const std::string& title, const std::string& filename, int threads = 0) const {
+        return PNGWriter::write(render(title, threads), filename);
+    }
+    
+    bool saveSVG(const std::string& title, const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out) return false;
+        out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << size << "\" height=\"" << size
+            << "\" viewBox=\"0 0 " << size << ' ' << size << "\">\n"
+            << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+        
+        std::string escaped;
+        for (char c : title) {
+            if (c == '<') escaped += "&lt;";
+            else if (c == '>') escaped += "&gt;";
+            else if (c == '&') escaped += "&amp;";
+            else escaped += c;
+        }
+        out << "<text x=\"" << size / 2 << "\" y=\"" << margin / 2 << "\" font-family=\"sans-serif\" "
+            << "font-size=\"24\" text-anchor=\"middle\">" << escaped << "</text>\n";
+        
+        out << "<g stroke=\"rgb(0,0,255)\" stroke-width=\"" << EDGE_WIDTH << "\">\n";
+        int n = (int)points.size();
+        for (int v = 0; v < n; ++v) {
+            for (const std::uint32_t* u = graph.begin(v); u != graph.end(v); ++u) {
+                if (v >= (int)*u) continue;
+                out << "<line x1=\"" << toX(points[v].x) << "\" y1=\"" << toY(points[v].y)
+                    << "\" x2=\"" << toX(points[*u].x) << "\" y2=\"" << toY(points[*u].y) << "\"/>\n";
+            }
+        }
+        out << "</g>\n<g fill=\"rgb(31,119,180)\">\n";
+        for (const auto& p : points) {
+            out << "<circle cx=\"" << toX(p.x) << "\" cy=\"" << toY(p.y) << "\" r=\""
+                << VERTEX_RADIUS << "\"/>\n";
+        }
+        
+        out << "</g>\n<g font-family=\"sans-serif\" font-size=\"16\">\n"
+            << "<rect x=\"" << margin << "\" y=\"" << margin << "\" width=\"" << size - 2 * margin
+            << "\" height=\"" << size - 2 * margin << "\" fill=\"none\" stroke=\"black\"/>\n";
+        for (int k = 0; k <= 5; ++k) {
+            double value = extent * k / 5;
+            int label = (int)std::lround(value);
+            out << "<text x=\"" << toX(value) << "\" y=\"" << size - margin + 24
+                << "\" text-anchor=\"middle\">" << label << "</text>\n"
+                << "<text x=\"" << margin - 10 << "\" y=\"" << toY(value) + 5
+                << "\" text-anchor=\"end\">" << label << "</text>\n";
+        }
+        out << "</g>\n</svg>\n";
+        return (bool)out;
+    }
+    
+    bool save(const std::string& title, const std::string& filename, int threads = 0) const {
+        bool svg = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".svg") == 0;
+        return svg ? saveSVG(title, filename) : savePNG(title, filename, threads);
+    }
+};
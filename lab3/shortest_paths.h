@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "csr_graph.h"
+#include "parallel.h"
+#include "union_find.h"
+
+// Ключ монотонной очереди для неотрицательного double: двоичное
+// представление таких чисел упорядочено так же, как сами числа
+inline std::uint64_t distanceKey(double d) {
+    std::uint64_t key;
+    std::memcpy(&key, &d, sizeof(key));
+    return key;
+}
+
+inline double keyDistance(std::uint64_t key) {
+    double d;
+    std::memcpy(&d, &key, sizeof(d));
+    return d;
+}
+
+// Монотонная очередь с приоритетами (radix heap) по 64-битным ключам:
+// извлекаемые ключи не убывают, и добавлять можно только ключи не меньше
+// последнего извлеченного. Элемент лежит в корзине по старшему биту,
+// которым его ключ отличается от последнего извлеченного, и за все время
+// переносится не более 64 раз.
+template <typename Value>
+class RadixHeap {
+private:
+    std::vector<std::pair<std::uint64_t, Value>> buckets[65];
+    std::uint64_t last = 0;
+    size_t count = 0;
+    
+    int bucketOf(std::uint64_t key) const {
+        return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+    }
+    
+public:
+    bool empty() const { return count == 0; }
+    
+    void push(std::uint64_t key, Value value) {
+        buckets[bucketOf(key)].emplace_back(key, value);
+        ++count;
+    }
+    
+    std::pair<std::uint64_t, Value> pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            last = std::min_element(buckets[i].begin(), buckets[i].end())->first;
+            for (const auto& item : buckets[i]) buckets[bucketOf(item.first)].push_back(item);
+            buckets[i].clear();
+        }
+        auto item = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return item;
+    }
+    
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        last = 0;
+        count = 0;
+    }
+};
+
+const double UNREACHABLE = std::numeric_limits<double>::infinity();
+
+
+// Алгоритм Дейкстры на radix heap по длинам ребер weights (массив
+// параллелен массиву соседей CSR). Однопоточный, O(m + n log C).
+// Состояние между поисками сбрасывается только по достигнутым вершинам,
+// поэтому поиск в маленькой компоненте не трогает весь граф.
+class DijkstraEngine {
+private:
+    const CSRGraph& graph;
+    const std::vector<float>& weights;
+    RadixHeap<std::uint32_t> heap;
+    std::vector<double> dist;
+    std::vector<std::uint32_t> visited;
+    
+public:
+    DijkstraEngine(const CSRGraph& g, const std::vector<float>& w)
+        : graph(g), weights(w), dist(g.numVertices(), UNREACHABLE) {}
+    
+    double distance(int v) const { return dist[v]; }
+    
+    // Вершины, достигнутые последним поиском, в порядке удаления от источника
+    const std::vector<std::uint32_t>& reached() const { return visited; }
+    
+    // Поиск из source; возвращает эксцентриситет source
+    double run(int source) {
+        for (std::uint32_t v : visited) dist[v] = UNREACHABLE;
+        visited.clear();
+        heap.clear();
+        dist[source] = 0;
+        heap.push(distanceKey(0), source);
+        double eccentricity = 0;
+        while (!heap.empty()) {
+            auto [key, v] = heap.pop();
+            if (key != distanceKey(dist[v])) continue;   // устаревшая запись
+            visited.push_back(v);
+            eccentricity = dist[v];
+            for (std::int64_t k = graph.offset[v]; k < graph.offset[v + 1]; ++k) {
+                std::uint32_t u = graph.neighbors[k];
+                double candidate = dist[v] + weights[k];
+                if (candidate < dist[u]) {
+                    dist[u] = candidate;
+                    heap.push(distanceKey(candidate), u);
+                }
+            }
+        }
+        return eccentricity;
+    }
+    
+    // Расстояния до всех вершин (UNREACHABLE - недостижима)
+    double run(int source, std::vector<double>& out) {
+        double eccentricity = run(source);
+        out = dist;
+        return eccentricity;
+    }
+};
+
+// Параллельный поиск кратчайших путей delta-stepping (Meyer, Sanders).
+// Вершины раскладываются по корзинам ширины delta; корзина обрабатывается
+// раундами: легкие ребра (не длиннее delta) релаксируются параллельно, пока
+// корзина не опустеет, затем один раз - тяжелые ребра ее вершин. Расстояния
+// хранятся атомарно (двоичное представление double) и уменьшаются через CAS.
+// Результат совпадает с алгоритмом Дейкстры до последнего бита.
+class DeltaSteppingEngine {
+private:
+    const CSRGraph& graph;
+    const std::vector<float>& weights;
+    int threads;
+    double delta;
+    static constexpr int CHUNK = 256;
+    
+    std::vector<std::atomic<std::uint64_t>> dist;
+    std::vector<std::vector<std::uint32_t>> buckets;
+    std::vector<std::vector<std::pair<size_t, std::uint32_t>>> inserted;  // по потокам
+    std::vector<std::uint32_t> roundStamp, bucketStamp;
+    std::vector<std::uint32_t> visited;
+    
+    // Уменьшение расстояния до u; true, если оно уменьшилось
+    bool relax(std::uint32_t u, double candidate) {
+        std::uint64_t key = distanceKey(candidate);
+        std::uint64_t current = dist[u].load(std::memory_order_relaxed);
+        while (key < current) {
+            if (dist[u].compare_exchange_weak(current, key, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+    
+    size_t bucketOf(double d) const { return (size_t)(d / delta); }
+    
+    // Релаксация легких (light = true) или тяжелых ребер вершин list
+    void relaxEdges(const std::vector<std::uint32_t>& list, size_t first, bool light) {
+        parallelFor((int)(list.size() - first), threads, CHUNK, [&](int begin, int end, int thread) {
+            auto& out = inserted[thread];
+            for (int i = begin; i < end; ++i) {
+                std::uint32_t v = list[first + i];
+                double dv = distance(v);
+                for (std::int64_t k = graph.offset[v]; k < graph.offset[v + 1]; ++k) {
+                    if ((weights[k] <= delta) != light) continue;
+                    double candidate = dv + weights[k];
+                    std::uint32_t u = graph.neighbors[k];
+                    if (relax(u, candidate)) out.emplace_back(bucketOf(candidate), u);
+                }
+            }
+        });
+        for (auto& out : inserted) {
+            for (auto [bucket, u] : out) {
+                if (bucket >= buckets.size()) buckets.resize(bucket + 1);
+                buckets[bucket].push_back(u);
+            }
+            out.clear();
+        }
+    }
+    
+public:
+    // delta <= 0 - средняя длина ребра
+    DeltaSteppingEngine(const CSRGraph& g, const std::vector<float>& w, int threadCount = 0,
+                        double bucketWidth = 0)
+        : graph(g), weights(w), threads(threadCount > 0 ? threadCount : defaultThreadCount()),
+          delta(bucketWidth), dist(g.numVertices()), inserted(threads),
+          roundStamp(g.numVertices(), 0), bucketStamp(g.numVertices(), 0) {
+        if (delta <= 0) {
+            double total = 0;
+            for (float x : weights) total += x;
+            delta = weights.empty() ? 1 : std::max(total / weights.size(), 1e-9);
+        }
+        for (auto& d : dist) d.store(distanceKey(UNREACHABLE), std::memory_order_relaxed);
+    }
+    
+    double distance(int v) const {
+        return keyDistance(dist[v].load(std::memory_order_relaxed));
+    }
+    
+    // Вершины, достигнутые последним поиском (по корзинам)
+    const std::vector<std::uint32_t>& reached() const { return visited; }
+    
+    double run(int source) {
+        // Отметки раундов и корзин хранят номер + 1, 0 - "еще не было";
+        // сбрасываются, как и расстояния, только у достигнутых вершин
+        for (std::uint32_t v : visited) {
+            dist[v].store(distanceKey(UNREACHABLE), std::memory_order_relaxed);
+            roundStamp[v] = bucketStamp[v] = 0;
+        }
+        visited.clear();
+        buckets.assign(1, {});
+        dist[source].store(distanceKey(0), std::memory_order_relaxed);
+        buckets[0].push_back(source);
+        
+        // Каждая вершина попадает в visited один раз - в корзине своего
+        // окончательного расстояния; после корзины i ее вершины в visited[settled..]
+        std::vector<std::uint32_t> frontier;
+        std::uint32_t round = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            size_t settled = visited.size();
+            while (!buckets[i].empty()) {
+                ++round;
+                frontier.clear();
+                for (std::uint32_t v : buckets[i]) {
+                    // Записи вершин, ушедших в меньшую корзину, и повторы пропускаются
+                    if (bucketOf(distance(v)) != i || roundStamp[v] == round) continue;
+                    roundStamp[v] = round;
+                    frontier.push_back(v);
+                    if (bucketStamp[v] != i + 1) {
+                        bucketStamp[v] = i + 1;
+                        visited.push_back(v);
+                    }
+                }
+                buckets[i].clear();
+                relaxEdges(frontier, 0, true);
+            }
+            relaxEdges(visited, settled, false);
+            std::vector<std::uint32_t>().swap(buckets[i]);
+        }
+        
+        double eccentricity = 0;
+        for (std::uint32_t v : visited) eccentricity = std::max(eccentricity, distance(v));
+        return eccentricity;
+    }
+    
+    // Расстояния до всех вершин (UNREACHABLE - недостижима)
+    double run(int source, std::vector<double>& out) {
+        double eccentricity = run(source);
+        out.resize(dist.size());
+        for (size_t v = 0; v < dist.size(); ++v) out[v] = distance(v);
+        return eccentricity;
+    }
+};
+
+// Точный взвешенный диаметр (наибольшее конечное расстояние) методом
+// BoundingDiameters (Takes, Kosters): после поиска из v для каждой вершины w
+// ecc(w) >= max(d(v,w), ecc(v) - d(v,w)) и ecc(w) <= ecc(v) + d(v,w).
+// Вершины, чья верхняя оценка не больше найденного диаметра, отбрасываются;
+// поиски запускаются поочередно из вершин с наибольшей верхней и наименьшей
+// нижней оценкой. На геометрических графах хватает десятков поисков.
+// Компоненты связности обрабатываются по отдельности: в больших (от
+// PARALLEL_MIN вершин) поиск - delta-stepping при threads > 1, иначе Дейкстра.
+class WeightedDiameterSolver {
+private:
+    const CSRGraph& graph;
+    const std::vector<float>& weights;
+    int threads;
+    static constexpr int PARALLEL_MIN = 1 << 14;
+    std::vector<double> lower, upper;
+    
+    // Диаметр компоненты с вершинами candidates (не меньше diameter)
+    template <typename Engine>
+    double boundComponent(Engine& engine, std::vector<std::uint32_t> candidates, double diameter) {
+        bool fromHigh = true;
+        while (!candidates.empty()) {
+            // Наибольшая верхняя оценка (при равенстве - наибольшая степень)
+            // или наименьшая нижняя
+            std::uint32_t best = candidates[0];
+            for (std::uint32_t w : candidates) {
+                if (fromHigh ? upper[w] > upper[best] ||
+                                   (upper[w] == upper[best] && graph.degree(w) > graph.degree(best))
+                             : lower[w] < lower[best]) {
+                    best = w;
+                }
+            }
+            fromHigh = !fromHigh;
+            
+            double ecc = engine.run(best);
+            diameter = std::max(diameter, ecc);
+            upper[best] = lower[best] = ecc;
+            
+            size_t kept = 0;
+            for (std::uint32_t w : candidates) {
+                double d = engine.distance(w);
+                lower[w] = std::max(lower[w], std::max(d, ecc - d));
+                upper[w] = std::min(upper[w], ecc + d);
+                if (w != best && upper[w] > diameter) candidates[kept++] = w;
+            }
+            candidates.resize(kept);
+        }
+        return diameter;
+    }
+    
+public:
+    WeightedDiameterSolver(const CSRGraph& g, const std::vector<float>& w, int threadCount = 0)
+        : graph(g), weights(w), threads(threadCount > 0 ? threadCount : defaultThreadCount()) {}
+    
+    double solve() {
+        const int n = graph.numVertices();
+        if (n == 0) return 0;
+        lower.assign(n, 0);
+        upper.assign(n, UNREACHABLE);
+        
+        // Вершины, сгруппированные по компонентам (подсчетом по корням)
+        ConcurrentUnionFind sets(n);
+        sets.uniteEdges(graph, threads);
+        std::vector<int> start(n + 1, 0);
+        std::vector<std::uint32_t> root(n), members(n);
+        for (int v = 0; v < n; ++v) ++start[(root[v] = sets.find(v)) + 1];
+        for (int c = 0; c < n; ++c) start[c + 1] += start[c];
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int v = 0; v < n; ++v) members[fill[root[v]]++] = v;
+        
+        DijkstraEngine dijkstra(graph, weights);
+        std::unique_ptr<DeltaSteppingEngine> stepping;
+        double diameter = 0;
+        for (int c = 0; c < n; ++c) {
+            int size = start[c + 1] - start[c];
+            if (size < 2) continue;
+            std::vector<std::uint32_t> component(members.begin() + start[c], members.begin() + start[c + 1]);
+            if (threads > 1 && size >= PARALLEL_MIN) {
+                if (!stepping) stepping = std::make_unique<DeltaSteppingEngine>(graph, weights, threads);
+                diameter = boundComponent(*stepping, std::move(component), diameter);
+            } else {
+                diameter = boundComponent(dijkstra, std::move(component), diameter);
+            }
+        }
+        return diameter;
+    }
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "csr_graph.h"
+#include "parallel.h"
+#include "union_find.h"
+
+// Минимальный остовный лес и его характеристики. Глубина дерева - высота
+// при подвешивании за центр (радиус дерева); для леса берется наибольшая
+// по деревьям величина.
+struct SpanningForest {
+    CSRGraph tree;                  // ребра леса с длинами в weights
+    double weight = 0;              // суммарная длина ребер
+    int trees = 0;                  // число деревьев (компонент графа)
+    int hopDiameter = 0;            // диаметр в ребрах
+    int depth = 0;                  // глубина от центра в ребрах
+    double weightedDiameter = 0;    // диаметр по длинам ребер
+    double weightedDepth = 0;       // глубина от взвешенного центра
+};
+
+// Параллельный алгоритм Борувки. В каждом раунде потоки по вершинам ищут
+// для каждой компоненты самое легкое выходящее из нее ребро (атомарный
+// минимум по номеру ячейки CSR), затем выбранные ребра объединяют компоненты.
+// Ребра сравниваются по (длина, меньший конец, больший конец) - порядок
+// строгий, поэтому циклов не возникает и лес совпадает с лесом Краскала.
+// Раундов не больше log2(n).
+class BoruvkaMST {
+private:
+    const CSRGraph& graph;
+    const std::vector<float>& weights;
+    int threads;
+    std::vector<std::uint32_t> source;  // начало ребра для каждой ячейки neighbors
+    
+    std::pair<std::uint32_t, std::uint32_t> ends(std::int64_t k) const {
+        return std::minmax(source[k], graph.neighbors[k]);
+    }
+    
+    bool lighter(std::int64_t a, std::int64_t b) const {
+        if (weights[a] != weights[b]) return weights[a] < weights[b];
+        return ends(a) < ends(b);
+    }
+    
+    // Обход дерева из start: число ребер и длина пути до каждой вершины
+    // компоненты; возвращает вершины компоненты в порядке обхода
+    static void traverse(const CSRGraph& tree, int start, std::vector<int>& hops,
+                         std::vector<double>& length, std::vector<int>& parent,
+                         std::vector<int>& order) {
+        order.assign(1, start);
+        hops[start] = 0;
+        length[start] = 0;
+        parent[start] = -1;
+        for (size_t i = 0; i < order.size(); ++i) {
+            int v = order[i];
+            for (std::int64_t k = tree.offset[v]; k < tree.offset[v + 1]; ++k) {
+                int u = tree.neighbors[k];
+                if (u == parent[v]) continue;
+                parent[u] = v;
+                hops[u] = hops[v] + 1;
+                length[u] = length[v] + tree.weights[k];
+                order.push_back(u);
+            }
+        }
+    }
+    
+    // Диаметры и радиусы деревьев: на дереве два обхода (от любой вершины
+    // до самой дальней и от нее) дают диаметр точно, центр лежит на нем
+    static void measureTrees(SpanningForest& forest) {
+        const CSRGraph& tree = forest.tree;
+        const int n = tree.numVertices();
+        std::vector<int> hops(n), parent(n), order;
+        std::vector<double> length(n);
+        std::vector<char> seen(n, 0);
+        for (int start = 0; start < n; ++start) {
+            if (seen[start]) continue;
+            ++forest.trees;
+            traverse(tree, start, hops, length, parent, order);
+            for (int v : order) seen[v] = 1;
+            
+            auto farthest = [&](auto key) {
+                return *std::max_element(order.begin(), order.end(),
+                                         [&](int x, int y) { return key(x) < key(y); });
+            };
+            auto byHops = [&](int v) { return hops[v]; };
+            auto byLength = [&](int v) { return length[v]; };
+            
+            traverse(tree, farthest(byHops), hops, length, parent, order);
+            int hopDiameter = hops[farthest(byHops)];
+            forest.hopDiameter = std::max(forest.hopDiameter, hopDiameter);
+            forest.depth = std::max(forest.depth, (hopDiameter + 1) / 2);
+            
+            traverse(tree, farthest(byLength), hops, length, parent, order);
+            int end = farthest(byLength);
+            double diameter = length[end];
+            double radius = diameter;
+            for (int v = end; v != -1; v = parent[v]) {
+                radius = std::min(radius, std::max(length[v], diameter - length[v]));
+            }
+            forest.weightedDiameter = std::max(forest.weightedDiameter, diameter);
+            forest.weightedDepth = std::max(forest.weightedDepth, radius);
+        }
+    }
+    
+public:
+    BoruvkaMST(const CSRGraph& g, const std::vector<float>& w, int threadCount = 0)
+        : graph(g), weights(w), threads(threadCount > 0 ? threadCount : defaultThreadCount()),
+          source(g.neighbors.size()) {
+        parallelFor(graph.numVertices(), threads, 1024, [&](int begin, int end, int) {
+            for (int v = begin; v < end; ++v) {
+                std::fill(source.begin() + graph.offset[v], source.begin() + graph.offset[v + 1], v);
+            }
+        });
+    }
+    
+    SpanningForest build() {
+        const int n = graph.numVertices();
+        ConcurrentUnionFind sets(n);
+        std::vector<std::uint32_t> component(n);
+        std::vector<std::atomic<std::int64_t>> best(n);
+        std::vector<std::int64_t> chosen;
+        
+        for (;;) {
+            parallelFor(n, threads, 1024, [&](int begin, int end, int) {
+                for (int v = begin; v < end; ++v) {
+                    component[v] = sets.find(v);
+                    best[v].store(-1, std::memory_order_relaxed);
+                }
+            });
+            parallelFor(n, threads, 1024, [&](int begin, int end, int) {
+                for (int v = begin; v < end; ++v) {
+                    // Сначала самое легкое ребро вершины, затем одна попытка
+                    // обновить минимум ее компоненты
+                    std::int64_t local = -1;
+                    for (std::int64_t k = graph.offset[v]; k < graph.offset[v + 1]; ++k) {
+                        if (component[graph.neighbors[k]] == component[v]) continue;
+                        if (local < 0 || lighter(k, local)) local = k;
+                    }
+                    if (local < 0) continue;
+                    auto& slot = best[component[v]];
+                    std::int64_t current = slot.load(std::memory_order_relaxed);
+                    while (current < 0 || lighter(local, current)) {
+                        if (slot.compare_exchange_weak(current, local, std::memory_order_relaxed)) break;
+                    }
+                }
+            });
+            
+            // Две компоненты могут выбрать одно и то же ребро - второе
+            // объединение вернет false
+            size_t before = chosen.size();
+            for (int c = 0; c < n; ++c) {
+                std::int64_t k = best[c].load(std::memory_order_relaxed);
+                if (k >= 0 && sets.unite(source[k], graph.neighbors[k])) chosen.push_back(k);
+            }
+            if (chosen.size() == before) break;
+        }
+        
+        SpanningForest forest;
+        CSRGraph& tree = forest.tree;
+        tree.offset.assign(n + 1, 0);
+        for (std::int64_t k : chosen) {
+            ++tree.offset[source[k] + 1];
+            ++tree.offset[graph.neighbors[k] + 1];
+            forest.weight += weights[k];
+        }
+        for (int v = 0; v < n; ++v) tree.offset[v + 1] += tree.offset[v];
+        tree.neighbors.resize(2 * chosen.size());
+        tree.weights.resize(2 * chosen.size());
+        std::vector<std::int64_t> fill(tree.offset.begin(), tree.offset.end() - 1);
+        for (std::int64_t k : chosen) {
+            auto [v, u] = ends(k);
+            tree.neighbors[fill[v]] = u;
+            tree.weights[fill[v]++] = weights[k];
+            tree.neighbors[fill[u]] = v;
+            tree.weights[fill[u]++] = weights[k];
+        }
+        
+        measureTrees(forest);
+        return forest;
+    }
+};
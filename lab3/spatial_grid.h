@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "geometry.h"
+
+// Равномерная сетка для поиска близких пар точек. Точки упорядочены по
+// ячейкам (сортировка подсчетом), ячейка c содержит order[start[c]..start[c+1]).
+class SpatialGrid {
+private:
+    double minX, minY;
+    double cellSize;
+    int cellsX, cellsY;
+    std::vector<int> start;
+    std::vector<int> order;
+    
+public:
+    // radius - расстояние, дальше которого пары не нужны (<= 0 - все пары).
+    // Ячейка не шире радиуса и содержит в среднем около pointsPerCell
+    // точек (но не меньше половины точки); если ячейка уже радиуса,
+    // соседние ячейки просматриваются на нужную глубину.
+    SpatialGrid(const std::vector<Point>& points, double radius, double pointsPerCell = 2) {
+        double maxX = 0, maxY = 0;
+        minX = minY = 0;
+        if (!points.empty()) {
+            minX = maxX = points[0].x;
+            minY = maxY = points[0].y;
+        }
+        for (const auto& p : points) {
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+        double width = std::max(maxX - minX, 1e-9);
+        double height = std::max(maxY - minY, 1e-9);
+        
+        double area = width * height;
+        double n = std::max<size_t>(points.size(), 1);
+        double minCell = std::sqrt(area / (2.0 * n));
+        cellSize = std::max(minCell, std::sqrt(area * pointsPerCell / n));
+        if (radius > 0) cellSize = std::max(minCell, std::min(radius, cellSize));
+        cellsX = std::min<long long>((long long)(width / cellSize) + 1, 1 << 20);
+        cellsY = std::min<long long>((long long)(height / cellSize) + 1, 1 << 20);
+        
+        std::vector<int> cell(points.size());
+        start.assign((size_t)cellsX * cellsY + 1, 0);
+        for (size_t i = 0; i < points.size(); ++i) {
+            cell[i] = cellOf(points[i]);
+            start[cell[i] + 1]++;
+        }
+        for (size_t c = 0; c + 1 < start.size(); ++c) start[c + 1] += start[c];
+        
+        order.resize(points.size());
+        std::vector<int> pos(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < points.size(); ++i) order[pos[cell[i]]++] = i;
+    }
+    
+    int numCells() const { return cellsX * cellsY; }
+    int columns() const { return cellsX; }
+    int rows() const { return cellsY; }
+    double size() const { return cellSize; }
+    
+    int cellOf(const Point& p) const {
+        int cx = std::min(cellsX - 1, (int)((p.x - minX) / cellSize));
+        int cy = std::min(cellsY - 1, (int)((p.y - minY) / cellSize));
+        return cy * cellsX + cx;
+    }
+    
+    const int* cellBegin(int c) const { return order.data() + start[c]; }
+    const int* cellEnd(int c) const { return order.data() + start[c + 1]; }
+    
+    // Наименьшее и наибольшее расстояние между точками ячеек, сдвинутых
+    // на (dx, dy)
+    double minGap(int dx, int dy) const {
+        double gx = std::max(0, std::abs(dx) - 1) * cellSize;
+        double gy = std::max(0, std::abs(dy) - 1) * cellSize;
+        return std::sqrt(gx * gx + gy * gy);
+    }
+    
+    double maxGap(int dx, int dy) const {
+        double gx = (std::abs(dx) + 1) * cellSize;
+        double gy = (std::abs(dy) + 1) * cellSize;
+        return std::sqrt(gx * gx + gy * gy);
+    }
+    
+    // Ячейки (dx, dy), которые нужно сравнить с данной, чтобы каждая пара
+    // на расстоянии <= radius встретилась ровно один раз: сама ячейка и
+    // "верхняя половина" окрестности. Ячейки, ближайшие точки которых
+    // дальше radius, отбрасываются. Без радиуса (radius <= 0) шаблон
+    // покрывает всю сетку: обход всех ячеек с ним стоит O(numCells()^2)
+    // пар ячеек. Это все равно дешевле перебора всех пар точек (в ячейке
+    // несколько точек), но для больших сетей радиус или порог вероятности
+    // лучше задавать.
+    std::vector<std::pair<int, int>> halfStencil(double radius) const {
+        int reach = radius > 0 ? (int)std::ceil(radius / cellSize) : std::max(cellsX, cellsY);
+        std::vector<std::pair<int, int>> offsets;
+        for (int dy = 0; dy <= reach; ++dy) {
+            for (int dx = -reach; dx <= reach; ++dx) {
+                if (dy == 0 && dx < 0) continue;
+                if (radius > 0 && minGap(dx, dy) > radius) continue;
+                offsets.emplace_back(dx, dy);
+            }
+        }
+        return offsets;
+    }
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Потоковое среднее и дисперсия (алгоритм Уэлфорда) с минимумом и максимумом.
+// Накопители разных потоков объединяются через merge.
+class RunningStats {
+private:
+    long long n = 0;
+    double meanValue = 0;
+    double m2 = 0;
+    double minValue = std::numeric_limits<double>::infinity();
+    double maxValue = -std::numeric_limits<double>::infinity();
+    
+public:
+    void add(double x) {
+        ++n;
+        double delta = x - meanValue;
+        meanValue += delta / n;
+        m2 += delta * (x - meanValue);
+        minValue = std::min(minValue, x);
+        maxValue = std::max(maxValue, x);
+    }
+    
+    void merge(const RunningStats& other) {
+        if (other.n == 0) return;
+        if (n == 0) {
+            *this = other;
+            return;
+        }
+        long long total = n + other.n;
+        double delta = other.meanValue - meanValue;
+        meanValue += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        n = total;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+    
+    long long count() const { return n; }
+    double mean() const { return meanValue; }
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    
+    // Полуширина доверительного интервала для среднего (z = 1.96 - 95%)
+    double confidenceHalfWidth(double z = 1.96) const {
+        return n > 1 ? z * stddev() / std::sqrt((double)n) : std::numeric_limits<double>::infinity();
+    }
+};
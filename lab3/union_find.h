@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "csr_graph.h"
+#include "parallel.h"
+
+// Система непересекающихся множеств без блокировок. Объединение подвешивает
+// корень с большим номером к корню с меньшим одной операцией CAS, поэтому
+// ссылки на родителя всегда ведут к меньшим номерам и циклов не возникает.
+// Поиск сокращает путь вдвое (каждая вершина переводится на деда).
+// unite и find можно вызывать из нескольких потоков одновременно.
+class ConcurrentUnionFind {
+private:
+    std::vector<std::atomic<std::uint32_t>> parent;
+    
+public:
+    explicit ConcurrentUnionFind(int n) : parent(n) {
+        for (int v = 0; v < n; ++v) parent[v].store(v, std::memory_order_relaxed);
+    }
+    
+    int size() const { return (int)parent.size(); }
+    
+    std::uint32_t find(std::uint32_t v) {
+        for (;;) {
+            std::uint32_t p = parent[v].load(std::memory_order_relaxed);
+            if (p == v) return v;
+            std::uint32_t grandparent = parent[p].load(std::memory_order_relaxed);
+            if (grandparent != p) {
+                parent[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            }
+            v = grandparent;
+        }
+    }
+    
+    // Объединение множеств a и b; false, если они уже совпадают
+    bool unite(std::uint32_t a, std::uint32_t b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a < b) std::swap(a, b);
+            std::uint32_t expected = a;
+            if (parent[a].compare_exchange_strong(expected, b)) return true;
+        }
+    }
+    
+    // Размеры всех множеств по убыванию (вызывать после завершения объединений)
+    std::vector<int> componentSizes() {
+        std::vector<int> count(parent.size(), 0);
+        for (std::uint32_t v = 0; v < parent.size(); ++v) ++count[find(v)];
+        std::vector<int> sizes;
+        for (int c : count) {
+            if (c > 0) sizes.push_back(c);
+        }
+        std::sort(sizes.begin(), sizes.end(), std::greater<int>());
+        return sizes;
+    }
+    
+    // Объединение концов всех ребер графа параллельно по вершинам
+    void uniteEdges(const CSRGraph& graph, int threads = 0) {
+        if (threads <= 0) threads = defaultThreadCount();
+        parallelFor(graph.numVertices(), threads, 1024, [&](int begin, int end, int) {
+            for (int v = begin; v < end; ++v) {
+                for (const std::uint32_t* u = graph.begin(v); u != graph.end(v); ++u) {
+                    if ((int)*u > v) unite(v, *u);
+                }
+            }
+        });
+    }
+    
+    // Компоненты связности графа
+    static std::vector<int> components(const CSRGraph& graph, int threads = 0) {
+        ConcurrentUnionFind sets(graph.numVertices());
+        sets.uniteEdges(graph, threads);
+        return sets.componentSizes();
+    }
+};